@@ -0,0 +1,100 @@
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdlib>
+#include <new>
+#include <atomic>
+#include "HT.h"
+#include "FHT.h"
+
+// Fails when a heterogeneous lookup builds a temporary std::string. Keys are longer than any small
+// string buffer, so such a temporary always reaches the counting operator new below.
+
+static std::atomic<size_t> allocations(0);
+
+// The replacement allocator stays out of line like the library one; once inlined, the compiler pairs
+// its malloc and free with new and delete expressions and reports them as mismatched.
+#if defined(_MSC_VER)
+#define ALLOCATOR_NOINLINE __declspec(noinline)
+#else
+#define ALLOCATOR_NOINLINE __attribute__((noinline))
+#endif
+
+ALLOCATOR_NOINLINE void* operator new(size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* ptr = std::malloc(size ? size : 1)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+ALLOCATOR_NOINLINE void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+ALLOCATOR_NOINLINE void operator delete(void* ptr, size_t) noexcept {
+    std::free(ptr);
+}
+
+template <typename Table>
+bool Check(const std::string& name) {
+    const size_t COUNT = 1000;
+    const size_t POPS = 10;
+
+    std::vector<std::string> keys;
+    std::vector<std::string> missing;
+    for (size_t i = 0; i < COUNT; i++) {
+        keys.push_back("allocation-check-present-key-" + std::to_string(i));
+        missing.push_back("allocation-check-missing-key-" + std::to_string(i));
+    }
+
+    Table table;
+    for (size_t i = 0; i < COUNT; i++) {
+        table.Push(keys[i], int(i));
+    }
+
+    size_t hits = 0;
+    size_t allocations_before = allocations;
+
+    for (size_t i = 0; i < COUNT; i++) {
+        std::string_view present = keys[i];
+        const char* absent = missing[i].c_str();
+
+        hits += table.Find(present) != nullptr;
+        hits += table.Find(keys[i].c_str()) != nullptr;
+        hits += table.Contains(present);
+        hits += table.Contains(absent);
+        hits += table.Find(std::string_view(missing[i])) != nullptr;
+    }
+    for (size_t i = 0; i < POPS; i++) {
+        table.Pop(std::string_view(keys[i]));
+        table.Pop(keys[COUNT - 1 - i].c_str());
+        table.Pop(missing[i].c_str());
+    }
+
+    size_t used = allocations - allocations_before;
+    bool passed = !used && hits == 3 * COUNT && table.Elements() == COUNT - 2 * POPS;
+
+    std::cout << (passed ? "PASS " : "FAIL ") << name << ": " << used << " allocations, " << hits << " hits" << std::endl;
+    return passed;
+}
+
+int main() {
+    bool passed = true;
+
+    try {
+        passed &= Check<HT::HashTable<int>>("Chaining");
+        passed &= Check<HT::HashTable<int, HF::WyHash, HT::IntrusiveChaining>>("Intrusive chaining");
+        passed &= Check<HT::HashTable<int, HF::WyHash, HT::UnrolledChaining>>("Unrolled chaining");
+        passed &= Check<HT::HashTable<int, HF::WyHash, HT::ListChaining, HT::LiveStats, HT::BloomFilter>>("Chaining (live stats, bloom filter)");
+        passed &= Check<FHT::FlatHashTable<int>>("Flat");
+        passed &= Check<FHT::CompactHashTable<int>>("Compact keys");
+    }
+    catch (const std::exception& ex) {
+        std::cerr << "Allocation check failed -> " << ex.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
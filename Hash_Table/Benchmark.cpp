@@ -0,0 +1,472 @@
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <functional>
+#include <unordered_map>
+#include <unordered_set>
+#include "HT.h"
+#include "FHT.h"
+#include "SHT.h"
+#include "LFHT.h"
+
+struct Options {
+    std::string workload = "all";
+    std::string engine = "all";
+    std::string key_type = "string";
+    size_t keys = 1 << 20;
+    size_t large_keys = 1 << 23;
+    size_t ops = 1 << 21;
+    double hit_ratio = 0.9;
+    double zipf = 0.99;
+    double read = 0.80;
+    double write = 0.15;
+    size_t key_length = 8;
+    size_t min_length = 4;
+    size_t max_length = 64;
+    size_t sample = 8;
+    uint64_t seed = 42;
+};
+
+enum class OpType : uint8_t {
+    FIND,
+    PUSH,
+    POP
+};
+
+struct Operation {
+    OpType type;
+    uint32_t key;
+};
+
+struct Workload {
+    std::string name;
+    size_t keys;
+    size_t min_length;
+    size_t max_length;
+    std::vector<Operation> ops;
+};
+
+struct Result {
+    double build_seconds;
+    double ops_per_second;
+    double p50;
+    double p99;
+    double p999;
+    size_t hits;
+};
+
+class Zipf {
+    size_t n;
+    double theta;
+    double alpha;
+    double zeta_n;
+    double eta;
+
+    static double Zeta(size_t n, double theta) {
+        double sum = 0.0;
+        for (size_t i = 1; i <= n; i++) {
+            sum += 1.0 / std::pow(double(i), theta);
+        }
+        return sum;
+    }
+
+public:
+    Zipf(size_t in_n, double in_theta) : n(in_n), theta(in_theta) {
+        double zeta_2 = Zeta(2, theta);
+        zeta_n = Zeta(n, theta);
+        alpha = 1.0 / (1.0 - theta);
+        eta = (1.0 - std::pow(2.0 / double(n), 1.0 - theta)) / (1.0 - zeta_2 / zeta_n);
+    }
+
+    size_t Next(std::mt19937_64& rng) {
+        double u = std::uniform_real_distribution<double>(0.0, 1.0)(rng);
+        double uz = u * zeta_n;
+
+        if (uz < 1.0) {
+            return 0;
+        }
+        if (uz < 1.0 + std::pow(0.5, theta)) {
+            return 1;
+        }
+
+        size_t rank = size_t(double(n) * std::pow(eta * u - eta + 1.0, alpha));
+        return rank < n ? rank : n - 1;
+    }
+};
+
+template <typename K>
+std::vector<K> GenerateKeys(size_t count, size_t min_length, size_t max_length, uint64_t seed) {
+    std::vector<K> keys;
+    keys.reserve(count);
+
+    if constexpr (std::is_same_v<K, std::string>) {
+        const char LETTERS[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+
+        if (std::pow(26.0, double(min_length)) < 4.0 * double(count)) {
+            throw std::invalid_argument("GenerateKeys(): " + std::to_string(min_length) + " letters are too few for " + std::to_string(count) + " distinct keys");
+        }
+
+        std::mt19937_64 rng(seed);
+        std::uniform_int_distribution<size_t> rnd_length(min_length, max_length);
+        std::uniform_int_distribution<int> rnd_letter(0, 25);
+        std::unordered_set<std::string> seen;
+        seen.reserve(count);
+
+        while (keys.size() < count) {
+            std::string key(rnd_length(rng), 'A');
+            for (char& c : key) {
+                c = LETTERS[rnd_letter(rng)];
+            }
+            if (seen.insert(key).second) {
+                keys.push_back(std::move(key));
+            }
+        }
+    }
+    else {
+        for (size_t i = 0; i < count; i++) {
+            keys.push_back(K(HF::Mix(seed + i)));
+        }
+    }
+
+    return keys;
+}
+
+Workload MakeWorkload(const std::string& name, const Options& options) {
+    Workload workload = { name, options.keys, options.key_length, options.key_length, {} };
+    std::mt19937_64 rng(options.seed);
+    std::uniform_real_distribution<double> rnd_real(0.0, 1.0);
+
+    if (name == "large") {
+        workload.keys = options.large_keys;
+    }
+    else if (name == "key-length") {
+        workload.min_length = options.min_length;
+        workload.max_length = options.max_length;
+    }
+
+    size_t n = workload.keys;
+    std::uniform_int_distribution<size_t> rnd_present(0, n - 1);
+    std::uniform_int_distribution<size_t> rnd_any(0, 2 * n - 1);
+
+    auto lookup_key = [&]() {
+        return uint32_t(rnd_real(rng) < options.hit_ratio ? rnd_present(rng) : n + rnd_present(rng));
+    };
+
+    workload.ops.reserve(options.ops);
+
+    if (name == "zipf") {
+        Zipf zipf(n, options.zipf);
+        for (size_t i = 0; i < options.ops; i++) {
+            workload.ops.push_back({ OpType::FIND, uint32_t(HF::Mix(zipf.Next(rng)) % n) });
+        }
+    }
+    else if (name == "mixed") {
+        for (size_t i = 0; i < options.ops; i++) {
+            double r = rnd_real(rng);
+            if (r < options.read) {
+                workload.ops.push_back({ OpType::FIND, lookup_key() });
+            }
+            else if (r < options.read + options.write) {
+                workload.ops.push_back({ OpType::PUSH, uint32_t(rnd_any(rng)) });
+            }
+            else {
+                workload.ops.push_back({ OpType::POP, uint32_t(rnd_any(rng)) });
+            }
+        }
+    }
+    else {
+        for (size_t i = 0; i < options.ops; i++) {
+            workload.ops.push_back({ OpType::FIND, lookup_key() });
+        }
+    }
+
+    return workload;
+}
+
+template <typename K>
+struct StdEngine {
+    std::unordered_map<K, int> table;
+
+    void Push(const K& key, int value) {
+        table[key] = value;
+    }
+
+    bool Find(const K& key) const {
+        return table.find(key) != table.end();
+    }
+
+    void Pop(const K& key) {
+        table.erase(key);
+    }
+};
+
+template <typename Table>
+struct NodeEngine {
+    Table table;
+
+    void Push(const typename Table::Key& key, int value) {
+        table.Push(key, value);
+    }
+
+    bool Find(const typename Table::Key& key) const {
+        return table.Find(key) != nullptr;
+    }
+
+    void Pop(const typename Table::Key& key) {
+        table.Pop(key);
+    }
+};
+
+template <typename Table>
+struct ValueEngine {
+    Table table;
+
+    void Push(const typename Table::Key& key, int value) {
+        table.Push(key, value);
+    }
+
+    bool Find(const typename Table::Key& key) const {
+        int value;
+        return table.Find(key, value);
+    }
+
+    void Pop(const typename Table::Key& key) {
+        table.Pop(key);
+    }
+};
+
+double Percentile(std::vector<uint64_t>& samples, double fraction) {
+    if (samples.empty()) {
+        return 0.0;
+    }
+
+    size_t index = size_t(fraction * double(samples.size() - 1));
+    std::nth_element(samples.begin(), samples.begin() + index, samples.end());
+    return double(samples[index]);
+}
+
+uint64_t TimerOverhead() {
+    using Clock = std::chrono::steady_clock;
+    static uint64_t overhead = []() {
+        std::vector<uint64_t> samples(100000);
+        for (uint64_t& sample : samples) {
+            Clock::time_point start = Clock::now();
+            sample = uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count());
+        }
+        std::nth_element(samples.begin(), samples.begin() + samples.size() / 2, samples.end());
+        return samples[samples.size() / 2];
+    }();
+
+    return overhead;
+}
+
+template <typename Engine, typename K>
+Result Run(const std::vector<K>& pool, const Workload& workload, size_t sample) {
+    using Clock = std::chrono::steady_clock;
+
+    Engine* engine = new Engine();
+    Result result = {};
+
+    Clock::time_point start_time = Clock::now();
+    for (size_t i = 0; i < workload.keys; i++) {
+        engine->Push(pool[i], int(i));
+    }
+    result.build_seconds = std::chrono::duration<double>(Clock::now() - start_time).count();
+
+    std::vector<uint64_t> latencies;
+    latencies.reserve(workload.ops.size() / sample + 1);
+    uint64_t overhead = TimerOverhead();
+
+    auto execute = [engine, &pool, &result](const Operation& op) {
+        const K& key = pool[op.key];
+        switch (op.type) {
+        case OpType::FIND:
+            result.hits += engine->Find(key);
+            break;
+        case OpType::PUSH:
+            engine->Push(key, int(op.key));
+            break;
+        case OpType::POP:
+            engine->Pop(key);
+            break;
+        }
+    };
+
+    start_time = Clock::now();
+    for (size_t i = 0; i < workload.ops.size(); i++) {
+        if (i % sample == 0) {
+            Clock::time_point op_start = Clock::now();
+            execute(workload.ops[i]);
+            uint64_t latency = uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - op_start).count());
+            latencies.push_back(latency > overhead ? latency - overhead : 0);
+        }
+        else {
+            execute(workload.ops[i]);
+        }
+    }
+    double seconds = std::chrono::duration<double>(Clock::now() - start_time).count();
+
+    delete engine;
+
+    result.ops_per_second = double(workload.ops.size()) / seconds;
+    result.p50 = Percentile(latencies, 0.50);
+    result.p99 = Percentile(latencies, 0.99);
+    result.p999 = Percentile(latencies, 0.999);
+
+    return result;
+}
+
+template <typename K>
+std::vector<std::pair<std::string, std::function<Result(const std::vector<K>&, const Workload&, size_t)>>> Engines() {
+    return {
+        { "std::unordered_map", Run<StdEngine<K>, K> },
+        { "HT chaining", Run<NodeEngine<HT::HashMap<K, int>>, K> },
+        { "HT intrusive", Run<NodeEngine<HT::HashMap<K, int, HF::Hash<K>, HF::Equal<K>, HT::IntrusiveChaining>>, K> },
+        { "HT unrolled", Run<NodeEngine<HT::HashMap<K, int, HF::Hash<K>, HF::Equal<K>, HT::UnrolledChaining>>, K> },
+        { "HT bloom filter", Run<NodeEngine<HT::HashMap<K, int, HF::Hash<K>, HF::Equal<K>, HT::ListChaining, HT::NoStats, HT::BloomFilter>>, K> },
+        { "FHT flat", Run<NodeEngine<FHT::FlatHashMap<K, int>>, K> },
+        { "SHT sharded", Run<ValueEngine<SHT::ShardedHashMap<K, int>>, K> },
+        { "LFHT lock-free read", Run<ValueEngine<LFHT::LockFreeHashMap<K, int>>, K> },
+    };
+}
+
+template <typename K>
+void RunWorkload(const std::string& name, const Options& options) {
+    if (name == "key-length" && !std::is_same_v<K, std::string>) {
+        std::cout << "Skipping key-length: needs --key-type=string" << std::endl << std::endl;
+        return;
+    }
+
+    Workload workload = MakeWorkload(name, options);
+    std::vector<K> pool = GenerateKeys<K>(2 * workload.keys, workload.min_length, workload.max_length, options.seed);
+
+    std::cout << "--------------------------------" << std::endl;
+    std::cout << "Workload: " << name << " (keys: " << workload.keys << ", ops: " << workload.ops.size() << ", key type: " << options.key_type;
+    if (std::is_same_v<K, std::string>) {
+        std::cout << ", key length: " << workload.min_length << "-" << workload.max_length;
+    }
+    std::cout << ")" << std::endl;
+    std::cout << "Timer overhead: " << TimerOverhead() << " ns, subtracted from latencies" << std::endl << std::endl;
+
+    std::cout << std::left << std::setw(22) << "engine" << std::right
+        << std::setw(12) << "build s" << std::setw(14) << "ops/s"
+        << std::setw(10) << "p50 ns" << std::setw(10) << "p99 ns" << std::setw(12) << "p99.9 ns"
+        << std::setw(12) << "hits" << std::endl;
+
+    for (const auto& engine : Engines<K>()) {
+        if (options.engine != "all" && options.engine != engine.first) {
+            continue;
+        }
+
+        Result result = engine.second(pool, workload, options.sample);
+
+        std::cout << std::left << std::setw(22) << engine.first << std::right << std::fixed
+            << std::setw(12) << std::setprecision(3) << result.build_seconds
+            << std::setw(14) << std::setprecision(0) << result.ops_per_second
+            << std::setw(10) << result.p50 << std::setw(10) << result.p99 << std::setw(12) << result.p999
+            << std::setw(12) << result.hits << std::endl;
+        std::cout.unsetf(std::ios::floatfield);
+    }
+
+    std::cout << std::endl;
+}
+
+void PrintUsage() {
+    Options defaults;
+
+    std::cout << "Usage: Hash_Table_Benchmark [--option=value ...]" << std::endl << std::endl;
+    std::cout << "  --workload=NAME     all, hit-miss, zipf, mixed, key-length, large (default: all)" << std::endl;
+    std::cout << "  --engine=NAME       all or one engine name, e.g. \"HT intrusive\" (default: all)" << std::endl;
+    std::cout << "  --key-type=TYPE     string or u64 (default: " << defaults.key_type << ")" << std::endl;
+    std::cout << "  --keys=N            keys loaded before the run (default: " << defaults.keys << ")" << std::endl;
+    std::cout << "  --large-keys=N      keys for the large workload, meant to exceed the LLC (default: " << defaults.large_keys << ")" << std::endl;
+    std::cout << "  --ops=N             operations per run (default: " << defaults.ops << ")" << std::endl;
+    std::cout << "  --hit-ratio=R       share of lookups for present keys (default: " << defaults.hit_ratio << ")" << std::endl;
+    std::cout << "  --zipf=S            Zipf skew, 0 < S < 1 (default: " << defaults.zipf << ")" << std::endl;
+    std::cout << "  --read=R --write=W  mixed workload shares, the rest are deletes (default: " << defaults.read << ", " << defaults.write << ")" << std::endl;
+    std::cout << "  --key-length=L      string key length (default: " << defaults.key_length << ")" << std::endl;
+    std::cout << "  --min-length=L --max-length=L  key-length workload range (default: " << defaults.min_length << "-" << defaults.max_length << ")" << std::endl;
+    std::cout << "  --sample=K          time every K-th operation for percentiles (default: " << defaults.sample << ")" << std::endl;
+    std::cout << "  --seed=S            workload seed (default: " << defaults.seed << ")" << std::endl;
+}
+
+bool ParseOptions(int argc, char** argv, Options& options) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        size_t equals = arg.find('=');
+
+        if (arg.rfind("--", 0) != 0 || equals == std::string::npos) {
+            return false;
+        }
+
+        std::string name = arg.substr(2, equals - 2);
+        std::string value = arg.substr(equals + 1);
+
+        try {
+            if (name == "workload") options.workload = value;
+            else if (name == "engine") options.engine = value;
+            else if (name == "key-type") options.key_type = value;
+            else if (name == "keys") options.keys = std::stoull(value);
+            else if (name == "large-keys") options.large_keys = std::stoull(value);
+            else if (name == "ops") options.ops = std::stoull(value);
+            else if (name == "hit-ratio") options.hit_ratio = std::stod(value);
+            else if (name == "zipf") options.zipf = std::stod(value);
+            else if (name == "read") options.read = std::stod(value);
+            else if (name == "write") options.write = std::stod(value);
+            else if (name == "key-length") options.key_length = std::stoull(value);
+            else if (name == "min-length") options.min_length = std::stoull(value);
+            else if (name == "max-length") options.max_length = std::stoull(value);
+            else if (name == "sample") options.sample = std::stoull(value);
+            else if (name == "seed") options.seed = std::stoull(value);
+            else return false;
+        }
+        catch (const std::exception&) {
+            return false;
+        }
+    }
+
+    return (options.key_type == "string" || options.key_type == "u64") && options.keys && options.large_keys && options.sample
+        && options.zipf > 0.0 && options.zipf < 1.0 && options.min_length <= options.max_length
+        && 2 * std::max(options.keys, options.large_keys) <= UINT32_MAX;
+}
+
+template <typename K>
+void RunAll(const Options& options) {
+    const char* WORKLOADS[] = { "hit-miss", "zipf", "mixed", "key-length", "large" };
+
+    for (const char* name : WORKLOADS) {
+        if (options.workload == "all" || options.workload == name) {
+            RunWorkload<K>(name, options);
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    Options options;
+
+    if (!ParseOptions(argc, argv, options)) {
+        PrintUsage();
+        return 1;
+    }
+
+    try {
+        if (options.key_type == "string") {
+            RunAll<std::string>(options);
+        }
+        else {
+            RunAll<uint64_t>(options);
+        }
+    }
+    catch (const std::exception& ex) {
+        std::cerr << "Benchmark failed -> " << ex.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -1,77 +1,505 @@
 #pragma once
 #include <string>
+#include <stdexcept>
+#include <utility>
+#include <new>
+#include <memory>
+#include <cstdlib>
+#include <cstddef>
+#include <type_traits>
+#include <functional>
+#include <vector>
+#include <thread>
+#include <exception>
+#include <cstring>
+#include <cstdint>
 
 namespace DA {
 
-	template <typename T>
+	// Capacity multiplies by GROWTH when the array is full and divides by GROWTH once fewer than
+	// capacity / SHRINK elements remain. SHRINK > GROWTH leaves a gap between the two thresholds,
+	// so alternating Push/Pop at a boundary does not reallocate every time.
+	struct DefaultGrowth {
+		static constexpr size_t GROWTH = 2;
+		static constexpr size_t SHRINK = 4;
+	};
+
+	template <typename T, typename Growth = DefaultGrowth>
 	class DynArr {
 
+		static_assert(Growth::GROWTH >= 2, "DA::DynArr: GROWTH must be at least 2");
+		static_assert(Growth::SHRINK > Growth::GROWTH, "DA::DynArr: SHRINK must be greater than GROWTH");
+
+		// Trivially copyable elements are relocated with realloc instead of being moved one by one.
+		static constexpr bool RELOCATABLE = std::is_trivially_copyable_v<T> && alignof(T) <= alignof(std::max_align_t);
+
 		T* arr;
 		size_t size;
 		size_t capacity;
-		const int FACTOR = 2;
 
-		void ExpandArray() {
-			size_t new_capacity = capacity * FACTOR;
-			T* new_arr = nullptr;
+		static T* Allocate(size_t count) {
+			if constexpr (RELOCATABLE) {
+				T* memory = static_cast<T*>(std::malloc(count * sizeof(T)));
+				if (!memory) {
+					throw std::bad_alloc();
+				}
+				return memory;
+			}
+			else {
+				return static_cast<T*>(::operator new(count * sizeof(T), std::align_val_t(alignof(T))));
+			}
+		}
 
-			try {
-				new_arr = new T[new_capacity];
-				TransferMainArray(new_arr, new_capacity);
+		static void Deallocate(T* memory) {
+			if constexpr (RELOCATABLE) {
+				std::free(memory);
 			}
-			catch (const std::bad_alloc& ex) {
-				throw std::runtime_error("DA::ExpandArray() -> " + std::string(ex.what()));
+			else {
+				::operator delete(memory, std::align_val_t(alignof(T)));
+			}
+		}
+
+		void Reallocate(size_t new_capacity) {
+			if (new_capacity < size) { throw std::length_error("DA::Reallocate(): new_capacity (" + std::to_string(new_capacity) + ") was smaller than the array size (" + std::to_string(int(size)) + ")"); }
+
+			if constexpr (RELOCATABLE) {
+				T* new_arr = static_cast<T*>(std::realloc(arr, new_capacity * sizeof(T)));
+				if (!new_arr) {
+					throw std::bad_alloc();
+				}
+				arr = new_arr;
+			}
+			else {
+				T* new_arr = Allocate(new_capacity);
+				size_t moved = 0;
+
+				try {
+					for (; moved < size; moved++) {
+						new (new_arr + moved) T(std::move_if_noexcept(arr[moved]));
+					}
+				}
+				catch (...) {
+					std::destroy_n(new_arr, moved);
+					Deallocate(new_arr);
+					throw;
+				}
+
+				std::destroy_n(arr, size);
+				Deallocate(arr);
+				arr = new_arr;
+			}
+
+			capacity = new_capacity;
+		}
+
+		void ExpandArray() {
+			try {
+				Reallocate(capacity * Growth::GROWTH);
 			}
 			catch (const std::exception& ex) {
-				delete[] new_arr;
 				throw std::runtime_error("DA::ExpandArray() -> " + std::string(ex.what()));
 			}
 		}
 
 		void ReduceArray() {
-			size_t new_capacity = capacity / FACTOR;
-			T* new_arr = nullptr;
-
 			try {
-				new_arr = new T[new_capacity];
-				TransferMainArray(new_arr, new_capacity);
-			}
-			catch (const std::bad_alloc& ex) {
-				throw std::runtime_error("DA::ReduceArray() -> " + std::string(ex.what()));
+				Reallocate(capacity / Growth::GROWTH);
 			}
 			catch (const std::exception& ex) {
-				delete[] new_arr;
 				throw std::runtime_error("DA::ReduceArray() -> " + std::string(ex.what()));
 			}
 		}
 
-		void TransferMainArray(T* in_arr, size_t in_capacity) {
-			if (!in_arr) { throw std::invalid_argument("DA::TransferMainArray(): in_array was null"); }
-			if (in_capacity < size) { throw std::length_error("DA::TransferMainArray(): in_capacity (" + std::to_string(in_capacity) + ") was smaller than the array size (" + std::to_string(int(size)) + ")"); }
+		static constexpr size_t INSERTION_LIMIT = 16;
+		static constexpr size_t PARALLEL_LIMIT = size_t(1) << 16;
+		static constexpr bool RADIX = std::is_arithmetic_v<T> && (std::is_integral_v<T> || sizeof(T) == 4 || sizeof(T) == 8);
+
+		template <typename Compare>
+		struct Less {
+			Compare cmp;
 
-			for (int i = 0; i < size; i++) {
-				in_arr[i] = arr[i];
+			bool operator()(const T& left, const T& right) {
+				return cmp(left, right);
+			}
+		};
+
+		template <typename Compare>
+		struct Greater {
+			Compare cmp_lgreater;
+
+			bool operator()(const T& left, const T& right) {
+				return cmp_lgreater(right, left);
+			}
+		};
+
+		template <typename Compare>
+		static void InsertionSort(T* first, T* last, Compare& less) {
+			for (T* i = first + 1; i < last; i++) {
+				T value = std::move(*i);
+				T* j = i;
+				for (; j > first && less(value, *(j - 1)); j--) {
+					*j = std::move(*(j - 1));
+				}
+				*j = std::move(value);
+			}
+		}
+
+		template <typename Compare>
+		static void SiftDown(T* first, size_t root, size_t count, Compare& less) {
+			T value = std::move(first[root]);
+
+			for (size_t child = 2 * root + 1; child < count; child = 2 * root + 1) {
+				if (child + 1 < count && less(first[child], first[child + 1])) {
+					child++;
+				}
+				if (!less(value, first[child])) {
+					break;
+				}
+				first[root] = std::move(first[child]);
+				root = child;
+			}
+
+			first[root] = std::move(value);
+		}
+
+		template <typename Compare>
+		static void HeapSort(T* first, size_t count, Compare& less) {
+			for (size_t i = count / 2; i-- > 0;) {
+				SiftDown(first, i, count, less);
+			}
+			for (size_t end = count; end-- > 1;) {
+				std::swap(first[0], first[end]);
+				SiftDown(first, 0, end, less);
+			}
+		}
+
+		template <typename Compare>
+		static void MedianToFirst(T* result, T* a, T* b, T* c, Compare& less) {
+			if (less(*a, *b)) {
+				if (less(*b, *c)) {
+					std::swap(*result, *b);
+				}
+				else if (less(*a, *c)) {
+					std::swap(*result, *c);
+				}
+				else {
+					std::swap(*result, *a);
+				}
+			}
+			else if (less(*a, *c)) {
+				std::swap(*result, *a);
+			}
+			else if (less(*b, *c)) {
+				std::swap(*result, *c);
+			}
+			else {
+				std::swap(*result, *b);
 			}
-			
-			delete[] arr;
-			capacity = in_capacity;
-			arr = in_arr;
+		}
+
+		// The median-of-three pivot guarantees an element on each side, so the scans need no bounds checks.
+		template <typename Compare>
+		static T* Partition(T* first, T* last, const T& pivot, Compare& less) {
+			while (true) {
+				while (less(*first, pivot)) {
+					first++;
+				}
+				last--;
+				while (less(pivot, *last)) {
+					last--;
+				}
+				if (!(first < last)) {
+					return first;
+				}
+				std::swap(*first, *last);
+				first++;
+			}
+		}
+
+		// Quicksort that falls back to heapsort past 2 * log2(n) levels, so the worst case stays O(n log n).
+		template <typename Compare>
+		static void IntroSort(T* first, T* last, size_t depth, Compare& less) {
+			while (size_t(last - first) > INSERTION_LIMIT) {
+				if (depth == 0) {
+					HeapSort(first, size_t(last - first), less);
+					return;
+				}
+				depth--;
+
+				MedianToFirst(first, first + 1, first + (last - first) / 2, last - 1, less);
+				T* cut = Partition(first + 1, last, *first, less);
+
+				IntroSort(cut, last, depth, less);
+				last = cut;
+			}
+
+			InsertionSort(first, last, less);
+		}
+
+		template <typename Compare>
+		static void IntroSort(T* first, T* last, Compare& less) {
+			size_t depth = 0;
+			for (size_t n = size_t(last - first); n > 1; n >>= 1) {
+				depth += 2;
+			}
+
+			IntroSort(first, last, depth, less);
+		}
+
+		template <typename Compare>
+		static void Merge(T* first, T* middle, T* last, DynArr& buffer, Compare& less) {
+			buffer.Clear();
+			buffer.Reserve(size_t(middle - first));
+			for (T* i = first; i < middle; i++) {
+				buffer.Push(std::move(*i));
+			}
+
+			T* left = buffer.arr;
+			T* left_end = left + buffer.size;
+			T* right = middle;
+			T* out = first;
+
+			while (left < left_end && right < last) {
+				*out++ = less(*right, *left) ? std::move(*right++) : std::move(*left++);
+			}
+			while (left < left_end) {
+				*out++ = std::move(*left++);
+			}
+		}
+
+		template <typename Compare>
+		static void MergeSort(T* first, T* last, DynArr& buffer, Compare& less) {
+			size_t count = size_t(last - first);
+
+			for (size_t start = 0; start < count; start += INSERTION_LIMIT) {
+				InsertionSort(first + start, first + (count - start < INSERTION_LIMIT ? count : start + INSERTION_LIMIT), less);
+			}
+
+			for (size_t width = INSERTION_LIMIT; width < count; width *= 2) {
+				for (size_t start = 0; start + width < count; start += 2 * width) {
+					size_t end = count - start < 2 * width ? count : start + 2 * width;
+					Merge(first + start, first + start + width, first + end, buffer, less);
+				}
+			}
+		}
+
+		template <typename Function>
+		static void RunParallel(size_t threads, Function fn) {
+			std::vector<std::exception_ptr> errors(threads);
+			auto guarded = [&fn, &errors](size_t part) {
+				try {
+					fn(part);
+				}
+				catch (...) {
+					errors[part] = std::current_exception();
+				}
+			};
+
+			std::vector<std::thread> workers;
+			size_t started = 1;
+
+			try {
+				workers.reserve(threads);
+				for (; started < threads; started++) {
+					workers.emplace_back(guarded, started);
+				}
+			}
+			catch (...) {
+				// Parts without a thread run here, so every part is always processed.
+			}
+
+			guarded(0);
+			for (size_t t = started; t < threads; t++) {
+				guarded(t);
+			}
+
+			for (std::thread& worker : workers) {
+				worker.join();
+			}
+
+			for (const std::exception_ptr& error : errors) {
+				if (error) {
+					std::rethrow_exception(error);
+				}
+			}
+		}
+
+		// Above PARALLEL_LIMIT elements per thread, every thread sorts one chunk and the chunks
+		// are merged pairwise, with the merges of one round running in parallel.
+		template <typename Compare>
+		void SortRange(Compare less, bool stable) {
+			size_t threads = std::thread::hardware_concurrency();
+			if (size / PARALLEL_LIMIT < threads) {
+				threads = size / PARALLEL_LIMIT;
+			}
+
+			if (threads < 2) {
+				if (stable) {
+					DynArr buffer;
+					MergeSort(arr, arr + size, buffer, less);
+				}
+				else {
+					IntroSort(arr, arr + size, less);
+				}
+				return;
+			}
+
+			std::vector<size_t> bounds(threads + 1);
+			for (size_t t = 0; t <= threads; t++) {
+				bounds[t] = size * t / threads;
+			}
+
+			// Every part works on its own copy of the comparator.
+			RunParallel(threads, [this, &bounds, &less, stable](size_t part) {
+				Compare part_less = less;
+				if (stable) {
+					DynArr buffer;
+					MergeSort(arr + bounds[part], arr + bounds[part + 1], buffer, part_less);
+				}
+				else {
+					IntroSort(arr + bounds[part], arr + bounds[part + 1], part_less);
+				}
+			});
+
+			for (size_t width = 1; width < threads; width *= 2) {
+				size_t merges = (threads + 2 * width - 1) / (2 * width);
+
+				RunParallel(merges, [this, &bounds, &less, width, threads](size_t merge) {
+					size_t left = merge * 2 * width;
+					if (left + width < threads) {
+						size_t right = left + 2 * width < threads ? left + 2 * width : threads;
+						Compare part_less = less;
+						DynArr buffer;
+						Merge(arr + bounds[left], arr + bounds[left + width], arr + bounds[right], buffer, part_less);
+					}
+				});
+			}
+		}
+
+		template <typename Compare>
+		void SelectFront(size_t count, Compare& less) {
+			if (count > size) {
+				count = size;
+			}
+			if (!count) {
+				return;
+			}
+
+			for (size_t i = count / 2; i-- > 0;) {
+				SiftDown(arr, i, count, less);
+			}
+			for (size_t i = count; i < size; i++) {
+				if (less(arr[i], arr[0])) {
+					std::swap(arr[0], arr[i]);
+					SiftDown(arr, 0, count, less);
+				}
+			}
+			for (size_t end = count; end-- > 1;) {
+				std::swap(arr[0], arr[end]);
+				SiftDown(arr, 0, end, less);
+			}
+		}
+
+		using RadixKey = std::conditional_t<sizeof(T) == 1, uint8_t, std::conditional_t<sizeof(T) == 2, uint16_t, std::conditional_t<sizeof(T) == 4, uint32_t, uint64_t>>>;
+
+		// Maps T to an unsigned key with the same order: the sign bit is flipped for signed
+		// integers, and negative floats are fully inverted.
+		static RadixKey ToRadixKey(const T& value) {
+			RadixKey key = 0;
+			std::memcpy(&key, &value, sizeof(T));
+
+			constexpr RadixKey SIGN = RadixKey(RadixKey(1) << (sizeof(RadixKey) * 8 - 1));
+			if constexpr (std::is_floating_point_v<T>) {
+				return (key & SIGN) ? RadixKey(~key) : RadixKey(key | SIGN);
+			}
+			else if constexpr (std::is_signed_v<T>) {
+				return RadixKey(key ^ SIGN);
+			}
+			else {
+				return key;
+			}
+		}
+
+		void RadixSort() {
+			if (size <= INSERTION_LIMIT * 4) {
+				Less<std::less<>> less{ std::less<>() };
+				IntroSort(arr, arr + size, less);
+				return;
+			}
+
+			DynArr buffer(size);
+			T* source = arr;
+			T* target = buffer.arr;
+
+			for (size_t shift = 0; shift < sizeof(T) * 8; shift += 8) {
+				size_t counts[256] = {};
+				for (size_t i = 0; i < size; i++) {
+					counts[(ToRadixKey(source[i]) >> shift) & 0xff]++;
+				}
+				if (counts[(ToRadixKey(source[0]) >> shift) & 0xff] == size) {
+					continue;
+				}
+
+				size_t offset = 0;
+				for (size_t& count : counts) {
+					size_t n = count;
+					count = offset;
+					offset += n;
+				}
+				for (size_t i = 0; i < size; i++) {
+					target[counts[(ToRadixKey(source[i]) >> shift) & 0xff]++] = source[i];
+				}
+
+				std::swap(source, target);
+			}
+
+			if (source != arr) {
+				std::memcpy(arr, source, size * sizeof(T));
+			}
+		}
+
+		void Clear() {
+			std::destroy_n(arr, size);
+			size = 0;
 		}
 
 	public:
 		DynArr(size_t in_capacity = 1) {
 			size = 0;
-			capacity = in_capacity;
+			capacity = in_capacity ? in_capacity : 1;
 			try {
-				arr = new T[capacity]{ nullptr };
+				arr = Allocate(capacity);
 			}
 			catch (const std::bad_alloc& ex) {
 				throw std::runtime_error("DA::Constructor -> " + std::string(ex.what()));
 			}
 		}
 
+		DynArr(size_t in_count, const T& value) {
+			size = in_count;
+			capacity = in_count ? in_count : 1;
+			try {
+				arr = Allocate(capacity);
+			}
+			catch (const std::bad_alloc& ex) {
+				throw std::runtime_error("DA::Constructor -> " + std::string(ex.what()));
+			}
+
+			try {
+				std::uninitialized_fill_n(arr, size, value);
+			}
+			catch (...) {
+				Deallocate(arr);
+				throw;
+			}
+		}
+
+		DynArr(const DynArr&) = delete;
+		DynArr& operator=(const DynArr&) = delete;
+
 		~DynArr() {
-			delete[] arr;
+			std::destroy_n(arr, size);
+			Deallocate(arr);
 		}
 
 		size_t Size() const {
@@ -82,11 +510,46 @@ namespace DA {
 			return capacity;
 		}
 
-		const int Factor() {
-			return FACTOR;
+		static constexpr size_t Factor() {
+			return Growth::GROWTH;
 		}
 
-		void Push(T data) {
+		void Reserve(size_t in_capacity) {
+			if (in_capacity > capacity) {
+				try {
+					Reallocate(in_capacity);
+				}
+				catch (const std::exception& ex) {
+					throw std::runtime_error("DA::Reserve() -> " + std::string(ex.what()));
+				}
+			}
+		}
+
+		void ShrinkToFit() {
+			size_t fit = size ? size : 1;
+			if (fit < capacity) {
+				try {
+					Reallocate(fit);
+				}
+				catch (const std::exception& ex) {
+					throw std::runtime_error("DA::ShrinkToFit() -> " + std::string(ex.what()));
+				}
+			}
+		}
+
+		void Push(const T& data) {
+			if (size == capacity) {
+				// data may live in arr, so it is copied out before the old storage goes away.
+				T copy(data);
+				Push(std::move(copy));
+				return;
+			}
+
+			new (arr + size) T(data);
+			size++;
+		}
+
+		void Push(T&& data) {
 			if (size == capacity) {
 				try {
 					ExpandArray();
@@ -96,14 +559,29 @@ namespace DA {
 				}
 			}
 
-			arr[size] = data;
+			new (arr + size) T(std::move(data));
 			size++;
 		}
 
-		void Pop(size_t index = size - 1) {
+		void Pop() {
+			try {
+				Pop(size - 1);
+			}
+			catch (const std::exception& ex) {
+				throw std::runtime_error("DA::Pop() -> " + std::string(ex.what()));
+			}
+		}
+
+		void Pop(size_t index) {
 			if (index >= size) { throw std::length_error("DA::Pop(): index (" + std::to_string(index) + ") was greater or equal to array size (" + std::to_string(int(size)) + ")"); }
 
-			if (size == capacity / FACTOR) {
+			for (size_t i = index; i < size - 1; i++) {
+				arr[i] = std::move(arr[i + 1]);
+			}
+			size--;
+			std::destroy_at(arr + size);
+
+			if (capacity >= Growth::GROWTH && size < capacity / Growth::SHRINK) {
 				try {
 					ReduceArray();
 				}
@@ -111,63 +589,129 @@ namespace DA {
 					throw std::runtime_error("DA::Pop() -> " + std::string(ex.what()));
 				}
 			}
-
-			for (size_t i = index; i < size - 1; i++) {
-				arr[i] = arr[i + 1];
-			}
-			size--;
 		}
 
 		void Erase() {
-			delete[] arr;
-			arr = nullptr;
-
+			std::destroy_n(arr, size);
 			size = 0;
-			capacity = 1;
+
+			if (capacity > 1) {
+				try {
+					Reallocate(1);
+				}
+				catch (const std::bad_alloc& ex) {
+					throw std::runtime_error("DA::Erase() -> " + std::string(ex.what()));
+				}
+			}
+		}
+
+		// Sorts ascending with operator<. Arithmetic T takes an LSD radix sort.
+		void Sort() {
 			try {
-				arr = new T[capacity];
+				if constexpr (RADIX) {
+					RadixSort();
+				}
+				else {
+					SortRange(Less<std::less<>>{ std::less<>() }, false);
+				}
 			}
-			catch (const std::bad_alloc& ex) {
-				throw std::runtime_error("DA::Erase() -> " + std::string(ex.what()));
+			catch (const std::exception& ex) {
+				throw std::runtime_error("DA::Sort() -> " + std::string(ex.what()));
 			}
 		}
 
-		void Sort(bool(*cmp_lgreater)(T, T)) {
-			if (cmp_lgreater) {
-				for (int i = 0; i < size - 1; i++) {
-					for (int j = 0; j < size - i - 1; j++) {
-						if (cmp_lgreater(arr[j], arr[j + 1])) {
-							T temp = arr[j];
-							arr[j] = arr[j + 1];
-							arr[j + 1] = temp;
-						}
-					}
+		// A null comparator sorts ascending, as Sort() does.
+		void Sort(std::nullptr_t) {
+			Sort();
+		}
+
+		// cmp_lgreater(a, b) returns true when a belongs after b; any callable is accepted.
+		template <typename Compare>
+		void Sort(Compare cmp_lgreater) {
+			if constexpr (std::is_pointer_v<Compare>) {
+				if (!cmp_lgreater) {
+					Sort();
+					return;
 				}
 			}
-			else if constexpr (std::is_arithmetic_v<T>) {
-				for (int i = 0; i < size - 1; i++) {
-					for (int j = 0; j < size - i - 1; j++) {
-						if (arr[j] > arr[j + 1]) {
-							T temp = arr[j];
-							arr[j] = arr[j + 1];
-							arr[j + 1] = temp;
-						}
-					}
-				}
+
+			try {
+				SortRange(Greater<Compare>{ cmp_lgreater }, false);
 			}
-			else {
-				throw std::runtime_error("DA::Sort(): T was not arithmetic and no cmp was provided");
+			catch (const std::exception& ex) {
+				throw std::runtime_error("DA::Sort() -> " + std::string(ex.what()));
+			}
+		}
+
+		void StableSort() {
+			try {
+				SortRange(Less<std::less<>>{ std::less<>() }, true);
+			}
+			catch (const std::exception& ex) {
+				throw std::runtime_error("DA::StableSort() -> " + std::string(ex.what()));
+			}
+		}
+
+		template <typename Compare>
+		void StableSort(Compare cmp_lgreater) {
+			try {
+				SortRange(Greater<Compare>{ cmp_lgreater }, true);
+			}
+			catch (const std::exception& ex) {
+				throw std::runtime_error("DA::StableSort() -> " + std::string(ex.what()));
+			}
+		}
+
+		// Leaves the smallest count elements sorted at the front; the order of the rest is unspecified.
+		void PartialSort(size_t count) {
+			Less<std::less<>> less{ std::less<>() };
+			SelectFront(count, less);
+		}
+
+		template <typename Compare>
+		void PartialSort(size_t count, Compare cmp_lgreater) {
+			Greater<Compare> less{ cmp_lgreater };
+			SelectFront(count, less);
+		}
+
+		template <typename Function>
+		void ForEach(Function fn) {
+			for (size_t i = 0; i < size; i++) {
+				fn(arr[i]);
+			}
+		}
+
+		template <typename Function>
+		void ForEach(Function fn) const {
+			for (size_t i = 0; i < size; i++) {
+				fn(static_cast<const T&>(arr[i]));
 			}
 		}
 
+		T* begin() {
+			return arr;
+		}
+
+		T* end() {
+			return arr + size;
+		}
+
+		const T* begin() const {
+			return arr;
+		}
+
+		const T* end() const {
+			return arr + size;
+		}
+
 		const T& operator[](size_t index) const {
-			if (index >= capacity) { throw std::out_of_range("DA::Operator[]: index (" + std::to_string(index) + ") was greater or equal to array capacity (" + std::to_string(int(size)) + ")"); }
+			if (index >= size) { throw std::out_of_range("DA::Operator[]: index (" + std::to_string(index) + ") was greater or equal to array size (" + std::to_string(int(size)) + ")"); }
 			
 			return arr[index];
 		}
 
 		T& operator[](size_t index) {
-			if (index >= capacity) { throw std::out_of_range("DA::Operator[]: index (" + std::to_string(index) + ") was greater or equal to array capacity (" + std::to_string(int(size)) + ")"); }
+			if (index >= size) { throw std::out_of_range("DA::Operator[]: index (" + std::to_string(index) + ") was greater or equal to array size (" + std::to_string(int(size)) + ")"); }
 
 			return arr[index];
 		}
@@ -180,7 +724,7 @@ namespace DA {
 			std::string text = "Dynamic Array:\n";
 			text += "size: " + std::to_string(int(size)) + "\n";
 			text += "capacity: " + std::to_string(int(capacity)) + "\n";
-			text += "factor: " + std::to_string(int(FACTOR)) + "\n";
+			text += "factor: " + std::to_string(int(Growth::GROWTH)) + "\n";
 			text += "{\n";
 			if (cmp_string) {
 				for (int i = 0; i < limit; i++) {
@@ -1,36 +1,233 @@
 #pragma once
 #include <string>
+#include <stdexcept>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <type_traits>
+#include <functional>
+#include <utility>
+#include <new>
+#include "POOL.h"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
 
 namespace DLL {
 
-	template <typename T>
+	// One heap node per element.
+	struct Linked {};
+
+	// Several elements per block of about BYTES bytes, so walks touch one cache line per block.
+	template <size_t BYTES = 64>
+	struct Unrolled {};
+
+	// Cursors name one element and stay valid until that element is erased. In unrolled storage,
+	// OrderPush and InsertAfter may move the elements that follow the insertion point in its block.
+	template <typename T, typename Storage = Linked>
 	class DoubLinList {
 
+		static_assert(std::is_same_v<Storage, Linked>, "DLL::DoubLinList: unknown storage");
+
 		struct Node {
 			T data;
 			Node* next;
 			Node* prev;
 
-			Node(T in_data) {
-				data = in_data;
-				next = nullptr;
-				prev = nullptr;
-			}
+			template <typename U>
+			Node(U&& in_data) : data(std::forward<U>(in_data)), next(nullptr), prev(nullptr) {}
 
 			~Node() {
-				
+
+			}
+		};
+
+		template <bool CONST>
+		class BasicIterator {
+			template <bool>
+			friend class BasicIterator;
+
+			Node* node;
+
+		public:
+			using iterator_category = std::forward_iterator_tag;
+			using value_type = T;
+			using difference_type = std::ptrdiff_t;
+			using pointer = std::conditional_t<CONST, const T*, T*>;
+			using reference = std::conditional_t<CONST, const T&, T&>;
+
+			BasicIterator(Node* in_node = nullptr) : node(in_node) {}
+
+			template <bool OTHER, std::enable_if_t<CONST && !OTHER, int> = 0>
+			BasicIterator(const BasicIterator<OTHER>& other) : node(other.node) {}
+
+			reference operator*() const {
+				return node->data;
+			}
+
+			pointer operator->() const {
+				return &node->data;
+			}
+
+			BasicIterator& operator++() {
+				node = node->next;
+				return *this;
+			}
+
+			BasicIterator operator++(int) {
+				BasicIterator temp = *this;
+				node = node->next;
+				return temp;
+			}
+
+			bool operator==(const BasicIterator& other) const {
+				return node == other.node;
+			}
+
+			bool operator!=(const BasicIterator& other) const {
+				return node != other.node;
 			}
 		};
 
+	public:
+		using NodePool = POOL::Pool<Node>;
+		using Iterator = BasicIterator<false>;
+		using ConstIterator = BasicIterator<true>;
+		using Cursor = Node*;
+
+	private:
 		size_t size;
 		Node* head;
 		Node* tail;
+		NodePool* pool;
+
+		// Last position reached by operator[], so sequential indexing does not restart from an end.
+		mutable Node* cache_node;
+		mutable size_t cache_index;
+
+		template <typename U>
+		Node* NewNode(U&& data) {
+			if (pool) {
+				return pool->New(std::forward<U>(data));
+			}
+			return new Node(std::forward<U>(data));
+		}
+
+		void LinkFront(Node* node) {
+			cache_node = nullptr;
+
+			if (size == 0) {
+				head = node;
+				tail = node;
+			}
+			else {
+				head->prev = node;
+				node->next = head;
+				head = node;
+			}
+
+			size++;
+		}
+
+		void LinkBack(Node* node) {
+			cache_node = nullptr;
+
+			if (size == 0) {
+				head = node;
+				tail = node;
+			}
+			else {
+				tail->next = node;
+				node->prev = tail;
+				tail = node;
+			}
+
+			size++;
+		}
+
+		void LinkAfter(Node* position, Node* node) {
+			if (position == tail) {
+				LinkBack(node);
+				return;
+			}
+
+			cache_node = nullptr;
+
+			node->next = position->next;
+			position->next->prev = node;
+
+			node->prev = position;
+			position->next = node;
+
+			size++;
+		}
+
+		void DeleteNode(Node* node) {
+			if (pool) {
+				pool->Delete(node);
+			}
+			else {
+				delete node;
+			}
+		}
+
+		void RemoveNode(Node* temp) {
+			if (temp == head) {
+				PopFront();
+			}
+			else if (temp == tail) {
+				PopBack();
+			}
+			else {
+				cache_node = nullptr;
+
+				Node* prev = temp->prev;
+				Node* next = temp->next;
+
+				prev->next = next;
+				next->prev = prev;
+
+				DeleteNode(temp);
+				size--;
+			}
+		}
+
+		// Walks from whichever of head, tail and the cached position is closest to index.
+		Node* Locate(size_t index) const {
+			Node* temp = head;
+			size_t position = 0;
+
+			if (size - 1 - index < index) {
+				temp = tail;
+				position = size - 1;
+			}
+			if (cache_node && (cache_index > index ? cache_index - index : index - cache_index) < (position > index ? position - index : index - position)) {
+				temp = cache_node;
+				position = cache_index;
+			}
+
+			for (; position < index; position++) {
+				temp = temp->next;
+			}
+			for (; position > index; position--) {
+				temp = temp->prev;
+			}
+
+			cache_node = temp;
+			cache_index = index;
+
+			return temp;
+		}
 
 	public:
-		DoubLinList() {
+		DoubLinList(NodePool* in_pool = nullptr) {
 			size = 0;
 			head = nullptr;
 			tail = nullptr;
+			pool = in_pool;
+			cache_node = nullptr;
+			cache_index = 0;
 		}
 
 		~DoubLinList() {
@@ -41,121 +238,111 @@ namespace DLL {
 			return size;
 		}
 
-		void Push(T data) {
+		void SetPool(NodePool* in_pool) {
+			pool = in_pool;
+		}
+
+		Cursor Push(const T& data) {
 			try {
-				PushBack(data);
+				return PushBack(data);
 			}
 			catch (const std::exception& ex) {
 				throw std::runtime_error("DLL::Push() -> " + std::string(ex.what()));
 			}
 		}
 
-		void PushFront(T data) {
-			Node* node = nullptr;
+		Cursor Push(T&& data) {
 			try {
-				node = new Node(data);
+				return PushBack(std::move(data));
 			}
-			catch (const std::bad_alloc& ex) {
-				throw std::runtime_error("DLL::PushFront() -> " + std::string(ex.what()));
+			catch (const std::exception& ex) {
+				throw std::runtime_error("DLL::Push() -> " + std::string(ex.what()));
 			}
+		}
 
-			if (size == 0) {
-				head = node;
-				tail = node;
+		Cursor PushFront(const T& data) {
+			try {
+				Node* node = NewNode(data);
+				LinkFront(node);
+				return node;
 			}
-			else {
-				head->prev = node;
-				node->next = head;
-				head = node;
+			catch (const std::exception& ex) {
+				throw std::runtime_error("DLL::PushFront() -> " + std::string(ex.what()));
 			}
+		}
 
-			size++;
+		Cursor PushFront(T&& data) {
+			try {
+				Node* node = NewNode(std::move(data));
+				LinkFront(node);
+				return node;
+			}
+			catch (const std::exception& ex) {
+				throw std::runtime_error("DLL::PushFront() -> " + std::string(ex.what()));
+			}
 		}
 
-		void PushBack(T data) {
-			Node* node = nullptr;
+		Cursor PushBack(const T& data) {
 			try {
-				node = new Node(data);
+				Node* node = NewNode(data);
+				LinkBack(node);
+				return node;
 			}
-			catch (const std::bad_alloc& ex) {
+			catch (const std::exception& ex) {
 				throw std::runtime_error("DLL::PushBack() -> " + std::string(ex.what()));
 			}
+		}
 
-			if (size == 0) {
-				head = node;
-				tail = node;
+		Cursor PushBack(T&& data) {
+			try {
+				Node* node = NewNode(std::move(data));
+				LinkBack(node);
+				return node;
 			}
-			else {
-				tail->next = node;
-				node->prev = tail;
-				tail = node;
+			catch (const std::exception& ex) {
+				throw std::runtime_error("DLL::PushBack() -> " + std::string(ex.what()));
 			}
-
-			size++;
 		}
 
-		void OrderPush(T data, bool(*cmp_equal)(T, T) = nullptr) {
-			Node* node = nullptr;
+		Cursor InsertAfter(Cursor position, const T& data) {
+			if (!position) { throw std::invalid_argument("DLL::InsertAfter(): position was null"); }
+
 			try {
-				node = new Node(data);
+				Node* node = NewNode(data);
+				LinkAfter(position, node);
+				return node;
 			}
-			catch (const std::bad_alloc& ex) {
-				throw std::runtime_error("DLL::OrderPush() -> " + std::string(ex.what()));
+			catch (const std::exception& ex) {
+				throw std::runtime_error("DLL::InsertAfter() -> " + std::string(ex.what()));
 			}
+		}
 
-			if (size == 0) {
-				head = node;
-				tail = node;
-			}
-			else {
-				Node* current = head;
-				Node* temp = head;
+		// Places data after the last element equal to it when the head is equal to it, otherwise at the front.
+		template <typename Equal = std::equal_to<>>
+		void OrderPush(const T& data, Equal cmp_equal = Equal()) {
+			try {
+				if (size == 0) {
+					PushBack(data);
+					return;
+				}
 
-				while (current) {
-					if (cmp_equal) {
-						if (cmp_equal(node->data, current->data) && cmp_equal(current->data, temp->data)) {
-							temp = current;
-						}
-					}
-					else if constexpr (std::is_arithmetic_v<T>) {
-						if (node->data == current->data && current->data == temp->data) {
-							temp = current;
-						}
-					}
-					else {
-						throw std::runtime_error("T was not arithmetic and no cmp was provided");
+				Node* temp = head;
+				for (Node* current = head; current != nullptr; current = current->next) {
+					if (cmp_equal(data, current->data) && cmp_equal(current->data, temp->data)) {
+						temp = current;
 					}
-
-					current = current->next;
 				}
+
 				if (temp == head) {
-					try {
-						PushFront(data);
-					}
-					catch (const std::exception& ex) {
-						throw std::runtime_error("DLL::OrderPush() -> " + std::string(ex.what()));
-					}
-					delete node;
-				}
-				else if (temp == tail) {
-					try {
-						PushBack(data);
-					}
-					catch (const std::exception& ex) {
-						throw std::runtime_error("DLL::OrderPush() -> " + std::string(ex.what()));
-					}
-					delete node;
+					PushFront(data);
 				}
 				else {
-					node->next = temp->next;
-					temp->next->prev = node;
-
-					node->prev = temp;
-					temp->next = node;
+					InsertAfter(temp, data);
 				}
 			}
-
-			size++;
+			catch (const std::exception& ex) {
+				throw std::runtime_error("DLL::OrderPush() -> " + std::string(ex.what()));
+			}
 		}
 
 		void Pop() {
@@ -170,17 +357,19 @@ namespace DLL {
 		void PopFront() {
 			if (!size) { throw std::length_error("DLL::PopFront(): list was empty"); }
 
-			else if (size > 1) {
+			cache_node = nullptr;
+
+			if (size > 1) {
 				Node* temp = head->next;
 
-				delete head;
+				DeleteNode(head);
 				head = temp;
 				head->prev = nullptr;
 
 				size--;
 			}
 			else {
-				delete head;
+				DeleteNode(head);
 				head = tail = nullptr;
 
 				size--;
@@ -190,58 +379,49 @@ namespace DLL {
 		void PopBack() {
 			if (!size) { throw std::length_error("DLL::PopBack(): list was empty"); }
 
-			else if (size > 1) {
+			cache_node = nullptr;
+
+			if (size > 1) {
 				Node* temp = tail->prev;
 
-				delete tail;
+				DeleteNode(tail);
 				tail = temp;
 				tail->next = nullptr;
 
 				size--;
 			}
 			else {
-				delete tail;
+				DeleteNode(tail);
 				head = tail = nullptr;
 
 				size--;
 			}
 		}
 
-		bool Remove(T data, bool(*cmp_equal)(T, T) = nullptr) {
-			Node* temp = nullptr;
-			try {
-				temp = Find(data, cmp_equal);
-			}
-			catch (const std::exception& ex) {
-				throw std::runtime_error("DLL::Remove() -> " + std::string(ex.what()));
-			}
-
-			if (temp) {
-				if (temp == head) {
-					try {
-						PopFront();
-					}
-					catch (const std::exception& ex) {
-						throw std::runtime_error("DLL::Remove() -> " + std::string(ex.what()));
-					}
+		template <typename Equal = std::equal_to<>>
+		bool Remove(const T& data, Equal cmp_equal = Equal()) {
+			if (Node* temp = Find(data, cmp_equal)) {
+				try {
+					RemoveNode(temp);
 				}
-				else if (temp == tail) {
-					try {
-						PopBack();
-					}
-					catch (const std::exception& ex) {
-						throw std::runtime_error("DLL::Remove() -> " + std::string(ex.what()));
-					}
+				catch (const std::exception& ex) {
+					throw std::runtime_error("DLL::Remove() -> " + std::string(ex.what()));
 				}
-				else {
-					Node* prev = temp->prev;
-					Node* next = temp->next;
 
-					prev->next = next;
-					next->prev = prev;
+				return true;
+			}
+
+			return false;
+		}
 
-					delete temp;
-					size--;
+		template <typename Predicate>
+		bool RemoveIf(Predicate pred) {
+			if (Node* temp = FindIf(pred)) {
+				try {
+					RemoveNode(temp);
+				}
+				catch (const std::exception& ex) {
+					throw std::runtime_error("DLL::RemoveIf() -> " + std::string(ex.what()));
 				}
 
 				return true;
@@ -250,83 +430,128 @@ namespace DLL {
 			return false;
 		}
 
+		// Erases the element under the cursor in O(1) and returns the cursor of the next one.
+		Cursor EraseAt(Cursor position) {
+			if (!position) { throw std::invalid_argument("DLL::EraseAt(): position was null"); }
+
+			Node* next = position->next;
+			RemoveNode(position);
+
+			return next;
+		}
+
+		// Relinks the element under the cursor at the head in O(1); the cursor stays valid and is returned.
+		Cursor MoveToFront(Cursor position) {
+			if (!position) { throw std::invalid_argument("DLL::MoveToFront(): position was null"); }
+
+			if (position != head) {
+				cache_node = nullptr;
+
+				position->prev->next = position->next;
+				(position->next ? position->next->prev : tail) = position->prev;
+
+				position->prev = nullptr;
+				position->next = head;
+				head->prev = position;
+				head = position;
+			}
+
+			return position;
+		}
+
 		void Erase() {
 			Node* temp;
 
 			while (tail) {
 				temp = tail->prev;
-				delete tail;
+				DeleteNode(tail);
 				tail = temp;
 			}
 
 			head = nullptr;
 			size = 0;
+			cache_node = nullptr;
 		}
 
-		Node* Find(T data, bool(*cmp_equal)(T, T) = nullptr) const {
-			Node* current = head;
-
-			while (current != nullptr) {
-				if (cmp_equal) {
-					if (cmp_equal(current->data, data)) {
-						return current;
-					}
-				}
-				else if constexpr (std::is_arithmetic_v<T>) {
-					if (current->data == data) {
-						return current;
-					}
-				}
-				else {
-					throw std::runtime_error("T was not arithmetic and no cmp was provided");
+		template <typename Equal = std::equal_to<>>
+		Cursor Find(const T& data, Equal cmp_equal = Equal()) const {
+			for (Node* current = head; current != nullptr; current = current->next) {
+				if (cmp_equal(current->data, data)) {
+					return current;
 				}
-
-				current = current->next;
 			}
 
 			return nullptr;
 		}
 
-		T& operator[](size_t index) {
-			if (index >= size) { throw std::out_of_range("DLL::Operator[]: index (" + std::to_string(index) + ") was greater or equal to list size (" + std::to_string(int(size)) + ")"); }
-			
-			Node* temp = nullptr;
+		Iterator begin() {
+			return Iterator(head);
+		}
 
-			if (index < size / 2) {
-				temp = head;
-				for (size_t i = 0; i < index; i++) {
-					temp = temp->next;
-				}
+		Iterator end() {
+			return Iterator();
+		}
+
+		ConstIterator begin() const {
+			return ConstIterator(head);
+		}
+
+		ConstIterator end() const {
+			return ConstIterator();
+		}
+
+		Node* Front() const {
+			return head;
+		}
+
+		Cursor First() const {
+			return head;
+		}
+
+		Cursor Last() const {
+			return tail;
+		}
+
+		static Cursor Next(Cursor position) {
+			return position->next;
+		}
+
+		static Cursor Prev(Cursor position) {
+			return position->prev;
+		}
+
+		static T& At(Cursor position) {
+			return position->data;
+		}
+
+		template <typename Function>
+		void ForEach(Function fn) const {
+			for (Node* current = head; current != nullptr; current = current->next) {
+				fn(current->data);
 			}
-			else {
-				temp = tail;
-				for (size_t i = size - 1; i > index; i--) {
-					temp = temp->prev;
+		}
+
+		template <typename Predicate>
+		Cursor FindIf(Predicate pred) const {
+			for (Node* current = head; current != nullptr; current = current->next) {
+				if (pred(current->data)) {
+					return current;
 				}
 			}
 
-			return temp->data;
+			return nullptr;
 		}
 
-		const T& operator[](size_t index) const {
+		T& operator[](size_t index) {
 			if (index >= size) { throw std::out_of_range("DLL::Operator[]: index (" + std::to_string(index) + ") was greater or equal to list size (" + std::to_string(int(size)) + ")"); }
 
-			Node* temp = nullptr;
+			return Locate(index)->data;
+		}
 
-			if (index < size / 2) {
-				temp = head;
-				for (size_t i = 0; i < index; i++) {
-					temp = temp->next;
-				}
-			}
-			else {
-				temp = tail;
-				for (size_t i = size - 1; i > index; i--) {
-					temp = temp->prev;
-				}
-			}
+		const T& operator[](size_t index) const {
+			if (index >= size) { throw std::out_of_range("DLL::Operator[]: index (" + std::to_string(index) + ") was greater or equal to list size (" + std::to_string(int(size)) + ")"); }
 
-			return temp->data;
+			return Locate(index)->data;
 		}
 
 		std::string ToString(unsigned int limit = 0, std::string(*cmp_string)(T) = nullptr) const {
@@ -366,4 +591,620 @@ namespace DLL {
 			return text;
 		}
 	};
-}
\ No newline at end of file
+
+	template <typename T, size_t BYTES>
+	class DoubLinList<T, Unrolled<BYTES>> {
+
+		static constexpr size_t HEADER = (2 * sizeof(void*) + sizeof(uint32_t) + alignof(T) - 1) / alignof(T) * alignof(T);
+		static constexpr size_t FIT = BYTES > HEADER + sizeof(T) ? (BYTES - HEADER) / sizeof(T) : 1;
+		static constexpr size_t CAPACITY = FIT < 32 ? FIT : 32;
+
+		static int Ctz(uint32_t bits) {
+#if defined(_MSC_VER)
+			unsigned long index;
+			_BitScanForward(&index, bits);
+			return int(index);
+#else
+			return __builtin_ctz(bits);
+#endif
+		}
+
+		static int Highest(uint32_t bits) {
+#if defined(_MSC_VER)
+			unsigned long index;
+			_BitScanReverse(&index, bits);
+			return int(index);
+#else
+			return 31 - __builtin_clz(bits);
+#endif
+		}
+
+		static size_t Popcount(uint32_t bits) {
+#if defined(_MSC_VER)
+			return size_t(__popcnt(bits));
+#else
+			return size_t(__builtin_popcount(bits));
+#endif
+		}
+
+		// Slots are never compacted, so an element keeps its slot until it is erased; used marks
+		// the occupied ones and a block is freed once it empties. Blocks start on a cache line.
+		struct alignas(64) Block {
+			Block* next = nullptr;
+			Block* prev = nullptr;
+			uint32_t used = 0;
+			alignas(T) unsigned char storage[CAPACITY * sizeof(T)];
+
+			T* Slot(size_t index) {
+				return std::launder(reinterpret_cast<T*>(storage) + index);
+			}
+
+			bool Has(size_t index) const {
+				return (used >> index) & 1;
+			}
+
+			size_t Lowest() const {
+				return size_t(Ctz(used));
+			}
+
+			size_t Highest() const {
+				return size_t(DoubLinList::Highest(used));
+			}
+		};
+
+	public:
+		struct Cursor {
+			Block* block = nullptr;
+			uint32_t index = 0;
+
+			explicit operator bool() const {
+				return block != nullptr;
+			}
+
+			bool operator==(const Cursor& other) const {
+				return block == other.block && index == other.index;
+			}
+
+			bool operator!=(const Cursor& other) const {
+				return !(*this == other);
+			}
+		};
+
+	private:
+		template <bool CONST>
+		class BasicIterator {
+			template <bool>
+			friend class BasicIterator;
+
+			Cursor position;
+
+		public:
+			using iterator_category = std::forward_iterator_tag;
+			using value_type = T;
+			using difference_type = std::ptrdiff_t;
+			using pointer = std::conditional_t<CONST, const T*, T*>;
+			using reference = std::conditional_t<CONST, const T&, T&>;
+
+			BasicIterator(Cursor in_position = Cursor()) : position(in_position) {}
+
+			template <bool OTHER, std::enable_if_t<CONST && !OTHER, int> = 0>
+			BasicIterator(const BasicIterator<OTHER>& other) : position(other.position) {}
+
+			reference operator*() const {
+				return *position.block->Slot(position.index);
+			}
+
+			pointer operator->() const {
+				return position.block->Slot(position.index);
+			}
+
+			BasicIterator& operator++() {
+				position = Next(position);
+				return *this;
+			}
+
+			BasicIterator operator++(int) {
+				BasicIterator temp = *this;
+				position = Next(position);
+				return temp;
+			}
+
+			bool operator==(const BasicIterator& other) const {
+				return position == other.position;
+			}
+
+			bool operator!=(const BasicIterator& other) const {
+				return position != other.position;
+			}
+		};
+
+	public:
+		using NodePool = POOL::Pool<Block>;
+		using Iterator = BasicIterator<false>;
+		using ConstIterator = BasicIterator<true>;
+
+	private:
+		size_t size;
+		Block* head;
+		Block* tail;
+		NodePool* pool;
+
+		// Block reached by the last operator[] and the index of its first element.
+		mutable Block* cache_block;
+		mutable size_t cache_index;
+
+		Block* NewBlock() {
+			if (pool) {
+				return pool->New();
+			}
+			return new Block();
+		}
+
+		void DeleteBlock(Block* block) {
+			if (pool) {
+				pool->Delete(block);
+			}
+			else {
+				delete block;
+			}
+		}
+
+		void LinkBlockAfter(Block* position, Block* block) {
+			block->prev = position;
+			block->next = position ? position->next : head;
+			(block->next ? block->next->prev : tail) = block;
+			(position ? position->next : head) = block;
+		}
+
+		void UnlinkBlock(Block* block) {
+			(block->prev ? block->prev->next : head) = block->next;
+			(block->next ? block->next->prev : tail) = block->prev;
+			DeleteBlock(block);
+		}
+
+		template <typename U>
+		Cursor Place(Block* block, size_t index, U&& data) {
+			new (block->Slot(index)) T(std::forward<U>(data));
+			block->used |= uint32_t(1) << index;
+			size++;
+			cache_block = nullptr;
+
+			return { block, uint32_t(index) };
+		}
+
+		// Constructs in a fresh block linked after position (at the head for null) and frees the block if T throws.
+		template <typename U>
+		Cursor PlaceInNewBlock(Block* position, size_t index, U&& data) {
+			Block* block = NewBlock();
+			try {
+				new (block->Slot(index)) T(std::forward<U>(data));
+			}
+			catch (...) {
+				DeleteBlock(block);
+				throw;
+			}
+
+			LinkBlockAfter(position, block);
+			block->used = uint32_t(1) << index;
+			size++;
+			cache_block = nullptr;
+
+			return { block, uint32_t(index) };
+		}
+
+		template <typename U>
+		Cursor PushFrontValue(U&& data) {
+			if (head && head->Lowest() > 0) {
+				return Place(head, head->Lowest() - 1, std::forward<U>(data));
+			}
+			return PlaceInNewBlock(nullptr, CAPACITY - 1, std::forward<U>(data));
+		}
+
+		template <typename U>
+		Cursor PushBackValue(U&& data) {
+			if (tail && tail->Highest() < CAPACITY - 1) {
+				return Place(tail, tail->Highest() + 1, std::forward<U>(data));
+			}
+			return PlaceInNewBlock(tail, 0, std::forward<U>(data));
+		}
+
+		static void Move(Block* from, size_t from_index, Block* to, size_t to_index) {
+			new (to->Slot(to_index)) T(std::move(*from->Slot(from_index)));
+			from->Slot(from_index)->~T();
+			from->used &= ~(uint32_t(1) << from_index);
+			to->used |= uint32_t(1) << to_index;
+		}
+
+		// Skips whole blocks by their element count, starting from the cached block when it is not past index.
+		Cursor Locate(size_t index) const {
+			Block* block = head;
+			size_t base = 0;
+
+			if (cache_block && cache_index <= index) {
+				block = cache_block;
+				base = cache_index;
+			}
+
+			for (size_t count = Popcount(block->used); base + count <= index; count = Popcount(block->used)) {
+				base += count;
+				block = block->next;
+			}
+
+			cache_block = block;
+			cache_index = base;
+
+			uint32_t used = block->used;
+			for (size_t skip = index - base; skip; skip--) {
+				used &= used - 1;
+			}
+
+			return { block, uint32_t(Ctz(used)) };
+		}
+
+	public:
+		DoubLinList(NodePool* in_pool = nullptr) {
+			size = 0;
+			head = nullptr;
+			tail = nullptr;
+			pool = in_pool;
+			cache_block = nullptr;
+			cache_index = 0;
+		}
+
+		DoubLinList(const DoubLinList&) = delete;
+		DoubLinList& operator=(const DoubLinList&) = delete;
+
+		~DoubLinList() {
+			Erase();
+		}
+
+		static constexpr size_t BlockCapacity() {
+			return CAPACITY;
+		}
+
+		size_t Size() const {
+			return size;
+		}
+
+		void SetPool(NodePool* in_pool) {
+			pool = in_pool;
+		}
+
+		Cursor Push(const T& data) {
+			try {
+				return PushBack(data);
+			}
+			catch (const std::exception& ex) {
+				throw std::runtime_error("DLL::Push() -> " + std::string(ex.what()));
+			}
+		}
+
+		Cursor Push(T&& data) {
+			try {
+				return PushBack(std::move(data));
+			}
+			catch (const std::exception& ex) {
+				throw std::runtime_error("DLL::Push() -> " + std::string(ex.what()));
+			}
+		}
+
+		Cursor PushFront(const T& data) {
+			try {
+				return PushFrontValue(data);
+			}
+			catch (const std::exception& ex) {
+				throw std::runtime_error("DLL::PushFront() -> " + std::string(ex.what()));
+			}
+		}
+
+		Cursor PushFront(T&& data) {
+			try {
+				return PushFrontValue(std::move(data));
+			}
+			catch (const std::exception& ex) {
+				throw std::runtime_error("DLL::PushFront() -> " + std::string(ex.what()));
+			}
+		}
+
+		Cursor PushBack(const T& data) {
+			try {
+				return PushBackValue(data);
+			}
+			catch (const std::exception& ex) {
+				throw std::runtime_error("DLL::PushBack() -> " + std::string(ex.what()));
+			}
+		}
+
+		Cursor PushBack(T&& data) {
+			try {
+				return PushBackValue(std::move(data));
+			}
+			catch (const std::exception& ex) {
+				throw std::runtime_error("DLL::PushBack() -> " + std::string(ex.what()));
+			}
+		}
+
+		// Uses a free slot right after position when there is one. Otherwise the elements that
+		// follow position in its block move to a new block, which invalidates their cursors.
+		Cursor InsertAfter(Cursor position, const T& data) {
+			if (!position) { throw std::invalid_argument("DLL::InsertAfter(): position was null"); }
+
+			try {
+				Block* block = position.block;
+				size_t index = position.index + 1;
+
+				if (index < CAPACITY && !block->Has(index)) {
+					return Place(block, index, data);
+				}
+				if (index == CAPACITY) {
+					return PlaceInNewBlock(block, 0, data);
+				}
+
+				T copy(data);
+				Block* spill = NewBlock();
+				LinkBlockAfter(block, spill);
+				for (size_t i = index; i < CAPACITY; i++) {
+					if (block->Has(i)) {
+						Move(block, i, spill, i);
+					}
+				}
+
+				return Place(block, index, std::move(copy));
+			}
+			catch (const std::exception& ex) {
+				throw std::runtime_error("DLL::InsertAfter() -> " + std::string(ex.what()));
+			}
+		}
+
+		// Places data after the last element equal to it when the head is equal to it, otherwise at the front.
+		template <typename Equal = std::equal_to<>>
+		void OrderPush(const T& data, Equal cmp_equal = Equal()) {
+			try {
+				if (size == 0) {
+					PushBack(data);
+					return;
+				}
+
+				Cursor temp = First();
+				for (Cursor current = First(); current; current = Next(current)) {
+					if (cmp_equal(data, At(current)) && cmp_equal(At(current), At(temp))) {
+						temp = current;
+					}
+				}
+
+				if (temp == First()) {
+					PushFront(data);
+				}
+				else {
+					InsertAfter(temp, data);
+				}
+			}
+			catch (const std::exception& ex) {
+				throw std::runtime_error("DLL::OrderPush() -> " + std::string(ex.what()));
+			}
+		}
+
+		void Pop() {
+			try {
+				PopFront();
+			}
+			catch (const std::exception& ex) {
+				throw std::runtime_error("DLL::Pop() -> " + std::string(ex.what()));
+			}
+		}
+
+		void PopFront() {
+			if (!size) { throw std::length_error("DLL::PopFront(): list was empty"); }
+
+			EraseAt(First());
+		}
+
+		void PopBack() {
+			if (!size) { throw std::length_error("DLL::PopBack(): list was empty"); }
+
+			EraseAt(Last());
+		}
+
+		template <typename Equal = std::equal_to<>>
+		bool Remove(const T& data, Equal cmp_equal = Equal()) {
+			if (Cursor temp = Find(data, cmp_equal)) {
+				EraseAt(temp);
+				return true;
+			}
+
+			return false;
+		}
+
+		template <typename Predicate>
+		bool RemoveIf(Predicate pred) {
+			if (Cursor temp = FindIf(pred)) {
+				EraseAt(temp);
+				return true;
+			}
+
+			return false;
+		}
+
+		// Erases the element under the cursor in O(1) and returns the cursor of the next one.
+		Cursor EraseAt(Cursor position) {
+			if (!position) { throw std::invalid_argument("DLL::EraseAt(): position was null"); }
+
+			Cursor next = Next(position);
+			Block* block = position.block;
+
+			block->Slot(position.index)->~T();
+			block->used &= ~(uint32_t(1) << position.index);
+			size--;
+			cache_block = nullptr;
+
+			if (!block->used) {
+				UnlinkBlock(block);
+			}
+
+			return next;
+		}
+
+		// Moves the element into the head block, so the old cursor is erased and the new one is returned.
+		Cursor MoveToFront(Cursor position) {
+			if (!position) { throw std::invalid_argument("DLL::MoveToFront(): position was null"); }
+
+			if (position == First()) {
+				return position;
+			}
+
+			try {
+				Cursor front = PushFrontValue(std::move(*position.block->Slot(position.index)));
+				EraseAt(position);
+				return front;
+			}
+			catch (const std::exception& ex) {
+				throw std::runtime_error("DLL::MoveToFront() -> " + std::string(ex.what()));
+			}
+		}
+
+		void Erase() {
+			while (head) {
+				Block* next = head->next;
+				for (uint32_t used = head->used; used; used &= used - 1) {
+					head->Slot(size_t(Ctz(used)))->~T();
+				}
+				DeleteBlock(head);
+				head = next;
+			}
+
+			tail = nullptr;
+			size = 0;
+			cache_block = nullptr;
+		}
+
+		template <typename Equal = std::equal_to<>>
+		Cursor Find(const T& data, Equal cmp_equal = Equal()) const {
+			return FindIf([&data, &cmp_equal](const T& current) { return cmp_equal(current, data); });
+		}
+
+		template <typename Predicate>
+		Cursor FindIf(Predicate pred) const {
+			for (Block* block = head; block; block = block->next) {
+				for (uint32_t used = block->used; used; used &= used - 1) {
+					size_t index = size_t(Ctz(used));
+					if (pred(*block->Slot(index))) {
+						return { block, uint32_t(index) };
+					}
+				}
+			}
+
+			return Cursor();
+		}
+
+		template <typename Function>
+		void ForEach(Function fn) const {
+			for (Block* block = head; block; block = block->next) {
+				for (uint32_t used = block->used; used; used &= used - 1) {
+					fn(*block->Slot(size_t(Ctz(used))));
+				}
+			}
+		}
+
+		Iterator begin() {
+			return Iterator(First());
+		}
+
+		Iterator end() {
+			return Iterator();
+		}
+
+		ConstIterator begin() const {
+			return ConstIterator(First());
+		}
+
+		ConstIterator end() const {
+			return ConstIterator();
+		}
+
+		Block* Front() const {
+			return head;
+		}
+
+		Cursor First() const {
+			return head ? Cursor{ head, uint32_t(head->Lowest()) } : Cursor();
+		}
+
+		Cursor Last() const {
+			return tail ? Cursor{ tail, uint32_t(tail->Highest()) } : Cursor();
+		}
+
+		static Cursor Next(Cursor position) {
+			uint32_t above = position.index + 1 < 32 ? position.block->used >> (position.index + 1) : 0;
+			if (above) {
+				return { position.block, uint32_t(position.index + 1 + Ctz(above)) };
+			}
+
+			Block* next = position.block->next;
+			return next ? Cursor{ next, uint32_t(next->Lowest()) } : Cursor();
+		}
+
+		static Cursor Prev(Cursor position) {
+			uint32_t below = position.block->used & ((uint32_t(1) << position.index) - 1);
+			if (below) {
+				return { position.block, uint32_t(Highest(below)) };
+			}
+
+			Block* prev = position.block->prev;
+			return prev ? Cursor{ prev, uint32_t(prev->Highest()) } : Cursor();
+		}
+
+		static T& At(Cursor position) {
+			return *position.block->Slot(position.index);
+		}
+
+		T& operator[](size_t index) {
+			if (index >= size) { throw std::out_of_range("DLL::Operator[]: index (" + std::to_string(index) + ") was greater or equal to list size (" + std::to_string(int(size)) + ")"); }
+
+			return At(Locate(index));
+		}
+
+		const T& operator[](size_t index) const {
+			if (index >= size) { throw std::out_of_range("DLL::Operator[]: index (" + std::to_string(index) + ") was greater or equal to list size (" + std::to_string(int(size)) + ")"); }
+
+			return At(Locate(index));
+		}
+
+		std::string ToString(unsigned int limit = 0, std::string(*cmp_string)(T) = nullptr) const {
+			if (limit <= 0 || limit > size) {
+				limit = size;
+			}
+
+			std::string text = "Unrolled Doubly Linked List:\n";
+			text += "size: " + std::to_string(int(size)) + "\n";
+			text += "block capacity: " + std::to_string(int(CAPACITY)) + "\n";
+			text += "{\n";
+
+			Cursor temp = First();
+			if (cmp_string) {
+				for (size_t i = 0; i < limit; i++) {
+					text += cmp_string(At(temp));
+					text += "\n";
+					temp = Next(temp);
+				}
+			}
+			else if constexpr (std::is_arithmetic_v<T>) {
+				for (size_t i = 0; i < limit; i++) {
+					text += std::to_string(At(temp));
+					text += "\n";
+					temp = Next(temp);
+				}
+			}
+			else {
+				text = "T is not arithmetic and no cmp was provided\n";
+			}
+
+			if (limit < size) {
+				text += "[...]\n";
+			}
+
+			text += "}\n";
+
+			return text;
+		}
+	};
+}
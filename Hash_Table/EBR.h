@@ -0,0 +1,183 @@
+#pragma once
+#include <string>
+#include <stdexcept>
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include <cstdint>
+
+namespace EBR {
+
+	class Domain {
+
+		static constexpr uint64_t INACTIVE = UINT64_MAX;
+
+		struct alignas(64) Record {
+			std::atomic<uint64_t> epoch;
+			std::atomic<bool> in_use;
+			Record* next;
+			unsigned int depth;
+
+			Record() : epoch(INACTIVE), in_use(true), next(nullptr), depth(0) {}
+		};
+
+		struct Retired {
+			void* ptr;
+			void(*deleter)(void*);
+			uint64_t epoch;
+		};
+
+		struct Holder {
+			Record* record;
+
+			~Holder() {
+				if (record) {
+					record->epoch.store(INACTIVE, std::memory_order_release);
+					record->in_use.store(false, std::memory_order_release);
+				}
+			}
+		};
+
+		alignas(64) std::atomic<uint64_t> epoch;
+		std::atomic<Record*> records;
+		std::mutex retired_mutex;
+		std::vector<Retired> retired;
+
+		Domain() : epoch(0), records(nullptr) {}
+
+		Record* Acquire() {
+			for (Record* record = records.load(std::memory_order_acquire); record; record = record->next) {
+				bool expected = false;
+				if (!record->in_use.load(std::memory_order_relaxed) && record->in_use.compare_exchange_strong(expected, true)) {
+					return record;
+				}
+			}
+
+			Record* record = nullptr;
+			try {
+				record = new Record();
+			}
+			catch (const std::bad_alloc& ex) {
+				throw std::runtime_error("EBR::Acquire() -> " + std::string(ex.what()));
+			}
+
+			Record* head = records.load(std::memory_order_relaxed);
+			do {
+				record->next = head;
+			} while (!records.compare_exchange_weak(head, record, std::memory_order_release, std::memory_order_relaxed));
+
+			return record;
+		}
+
+		Record* Local() {
+			thread_local Holder holder{ Acquire() };
+			return holder.record;
+		}
+
+		bool TryAdvance() {
+			uint64_t current = epoch.load(std::memory_order_seq_cst);
+
+			for (Record* record = records.load(std::memory_order_acquire); record; record = record->next) {
+				uint64_t local = record->epoch.load(std::memory_order_seq_cst);
+				if (local != INACTIVE && local != current) {
+					return false;
+				}
+			}
+
+			return epoch.compare_exchange_strong(current, current + 1);
+		}
+
+		void Reclaim() {
+			uint64_t current = epoch.load(std::memory_order_acquire);
+			size_t kept = 0;
+
+			for (size_t i = 0; i < retired.size(); i++) {
+				if (retired[i].epoch + 2 <= current) {
+					retired[i].deleter(retired[i].ptr);
+				}
+				else {
+					retired[kept++] = retired[i];
+				}
+			}
+
+			retired.resize(kept);
+		}
+
+	public:
+		class Guard {
+			Record* record;
+
+		public:
+			Guard(Domain& domain) : record(domain.Local()) {
+				if (record->depth++ == 0) {
+					record->epoch.store(domain.epoch.load(std::memory_order_acquire), std::memory_order_relaxed);
+					std::atomic_thread_fence(std::memory_order_seq_cst);
+				}
+			}
+
+			~Guard() {
+				if (--record->depth == 0) {
+					record->epoch.store(INACTIVE, std::memory_order_release);
+				}
+			}
+
+			Guard(const Guard&) = delete;
+			Guard& operator=(const Guard&) = delete;
+		};
+
+		~Domain() {
+			for (Retired& item : retired) {
+				item.deleter(item.ptr);
+			}
+
+			Record* record = records.load();
+			while (record) {
+				Record* next = record->next;
+				delete record;
+				record = next;
+			}
+		}
+
+		Domain(const Domain&) = delete;
+		Domain& operator=(const Domain&) = delete;
+
+		static Domain& Global() {
+			static Domain domain;
+			return domain;
+		}
+
+		size_t Pending() {
+			std::lock_guard<std::mutex> lock(retired_mutex);
+			return retired.size();
+		}
+
+		template <typename U>
+		void Retire(U* ptr) {
+			Retire(ptr, [](void* p) { delete static_cast<U*>(p); });
+		}
+
+		void Retire(void* ptr, void(*deleter)(void*)) {
+			std::lock_guard<std::mutex> lock(retired_mutex);
+
+			try {
+				retired.push_back({ ptr, deleter, epoch.load(std::memory_order_acquire) });
+			}
+			catch (const std::bad_alloc& ex) {
+				throw std::runtime_error("EBR::Retire() -> " + std::string(ex.what()));
+			}
+
+			if (retired.size() >= 64) {
+				TryAdvance();
+				Reclaim();
+			}
+		}
+
+		void Collect() {
+			std::lock_guard<std::mutex> lock(retired_mutex);
+
+			TryAdvance();
+			TryAdvance();
+			Reclaim();
+		}
+	};
+}
\ No newline at end of file
@@ -0,0 +1,757 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include "HF.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define FHT_SSE2
+#include <emmintrin.h>
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace FHT {
+
+	// Control bytes shared by the flat tables: EMPTY, DELETED or the top 7 hash bits of a full slot,
+	// matched 16 at a time.
+	class Control {
+	protected:
+		static constexpr int8_t EMPTY = -128;
+		static constexpr int8_t DELETED = -2;
+		static constexpr size_t GROUP = 16;
+
+		static int8_t H2(uint64_t hash) {
+			return int8_t(hash >> 57);
+		}
+
+		static unsigned int TrailingZeros(uint32_t mask) {
+#if defined(_MSC_VER)
+			unsigned long index;
+			_BitScanForward(&index, mask);
+			return index;
+#else
+			return __builtin_ctz(mask);
+#endif
+		}
+
+		static uint32_t MatchByte(const int8_t* group, int8_t byte) {
+#ifdef FHT_SSE2
+			__m128i ctrl = _mm_loadu_si128(reinterpret_cast<const __m128i*>(group));
+			return uint32_t(_mm_movemask_epi8(_mm_cmpeq_epi8(ctrl, _mm_set1_epi8(byte))));
+#else
+			uint32_t mask = 0;
+			for (size_t i = 0; i < GROUP; i++) {
+				if (group[i] == byte) {
+					mask |= 1u << i;
+				}
+			}
+			return mask;
+#endif
+		}
+
+		static uint32_t MatchFree(const int8_t* group) {
+#ifdef FHT_SSE2
+			__m128i ctrl = _mm_loadu_si128(reinterpret_cast<const __m128i*>(group));
+			return uint32_t(_mm_movemask_epi8(_mm_cmplt_epi8(ctrl, _mm_set1_epi8(-1))));
+#else
+			uint32_t mask = 0;
+			for (size_t i = 0; i < GROUP; i++) {
+				if (group[i] < -1) {
+					mask |= 1u << i;
+				}
+			}
+			return mask;
+#endif
+		}
+	};
+
+	template <typename K, typename T, typename Hash = HF::Hash<K>, typename KeyEqual = HF::Equal<K>>
+	class FlatHashMap : Control {
+
+	public:
+		using Key = K;
+
+		struct Node {
+			K key;
+			T value;
+
+			Node(K in_key, T in_value) : key(std::move(in_key)), value(std::move(in_value)) {}
+		};
+
+	private:
+		template <typename Q>
+		using EnableIfTransparent = std::enable_if_t<!std::is_void_v<Q> && HF::IsTransparent<Hash, KeyEqual>::value, int>;
+
+		const double FACTOR = 0.875;
+		Hash _hash;
+		KeyEqual _equal;
+		int8_t* _ctrl;
+		Node* _slots;
+		size_t _capacity;
+		size_t _elements;
+		size_t _deleted;
+
+		template <typename Q>
+		uint64_t HashOf(const Q& key) const {
+			return HF::Mix(_hash(key));
+		}
+
+		size_t Groups() const {
+			return _capacity / GROUP;
+		}
+
+		template <typename Q>
+		size_t FindIndex(const Q& key, uint64_t hash) const {
+			int8_t h2 = H2(hash);
+			size_t mask = Groups() - 1;
+			size_t group = size_t(hash) & mask;
+
+			for (size_t step = 1; step <= Groups(); step++) {
+				const int8_t* ctrl = _ctrl + group * GROUP;
+
+				for (uint32_t match = MatchByte(ctrl, h2); match; match &= match - 1) {
+					size_t index = group * GROUP + TrailingZeros(match);
+					if (_equal(_slots[index].key, key)) {
+						return index;
+					}
+				}
+
+				if (MatchByte(ctrl, EMPTY)) {
+					break;
+				}
+
+				group = (group + step) & mask;
+			}
+
+			return _capacity;
+		}
+
+		size_t FindFreeIndex(uint64_t hash) const {
+			size_t mask = Groups() - 1;
+			size_t group = size_t(hash) & mask;
+
+			for (size_t step = 1; step <= Groups(); step++) {
+				if (uint32_t free = MatchFree(_ctrl + group * GROUP)) {
+					return group * GROUP + TrailingZeros(free);
+				}
+
+				group = (group + step) & mask;
+			}
+
+			return _capacity;
+		}
+
+		void Allocate(size_t capacity) {
+			int8_t* ctrl = nullptr;
+
+			try {
+				ctrl = new int8_t[capacity];
+				_slots = static_cast<Node*>(::operator new(capacity * sizeof(Node)));
+			}
+			catch (const std::bad_alloc& ex) {
+				delete[] ctrl;
+				throw std::runtime_error("FHT::Allocate() -> " + std::string(ex.what()));
+			}
+
+			for (size_t i = 0; i < capacity; i++) {
+				ctrl[i] = EMPTY;
+			}
+
+			_ctrl = ctrl;
+			_capacity = capacity;
+			_deleted = 0;
+		}
+
+		void ReHash(size_t new_capacity) {
+			int8_t* old_ctrl = _ctrl;
+			Node* old_slots = _slots;
+			size_t old_capacity = _capacity;
+
+			try {
+				Allocate(new_capacity);
+			}
+			catch (const std::exception& ex) {
+				throw std::runtime_error("FHT::ReHash() -> " + std::string(ex.what()));
+			}
+
+			for (size_t i = 0; i < old_capacity; i++) {
+				if (old_ctrl[i] >= 0) {
+					uint64_t hash = HashOf(old_slots[i].key);
+					size_t index = FindFreeIndex(hash);
+
+					new (&_slots[index]) Node(std::move(old_slots[i]));
+					_ctrl[index] = H2(hash);
+					old_slots[i].~Node();
+				}
+			}
+
+			delete[] old_ctrl;
+			::operator delete(old_slots);
+		}
+
+		double CalculateLoad() const {
+			return 100 * double(_elements) / double(_capacity);
+		}
+
+		static std::string KeyToString(const K& key) {
+			if constexpr (std::is_convertible_v<const K&, std::string>) {
+				return key;
+			}
+			else if constexpr (std::is_arithmetic_v<K>) {
+				return std::to_string(key);
+			}
+			else {
+				return "?";
+			}
+		}
+
+		template <typename Q>
+		void PopKey(const Q& key) {
+			size_t index = FindIndex(key, HashOf(key));
+
+			if (index == _capacity) {
+				return;
+			}
+
+			_slots[index].~Node();
+
+			if (MatchByte(_ctrl + index / GROUP * GROUP, EMPTY)) {
+				_ctrl[index] = EMPTY;
+			}
+			else {
+				_ctrl[index] = DELETED;
+				_deleted++;
+			}
+
+			_elements--;
+		}
+
+	public:
+		FlatHashMap() : _ctrl(nullptr), _slots(nullptr), _capacity(0), _elements(0), _deleted(0) {
+			try {
+				Allocate(1024);
+			}
+			catch (const std::exception& ex) {
+				throw std::runtime_error("FHT::FlatHashMap() -> " + std::string(ex.what()));
+			}
+		}
+
+		~FlatHashMap() {
+			Erase();
+			delete[] _ctrl;
+			::operator delete(_slots);
+		}
+
+		FlatHashMap(const FlatHashMap&) = delete;
+		FlatHashMap& operator=(const FlatHashMap&) = delete;
+
+		size_t Elements() const {
+			return _elements;
+		}
+
+		size_t Capacity() const {
+			return _capacity;
+		}
+
+		size_t Tombstones() const {
+			return _deleted;
+		}
+
+		void Push(K key, T value) {
+			uint64_t hash = HashOf(key);
+			size_t index = FindIndex(key, hash);
+
+			if (index != _capacity) {
+				_slots[index].value = value;
+				return;
+			}
+
+			if (_elements + _deleted + 1 > _capacity * FACTOR) {
+				try {
+					ReHash(_deleted > _elements / 2 ? _capacity : _capacity * 2);
+				}
+				catch (const std::exception& ex) {
+					throw std::runtime_error("FHT::Push() -> " + std::string(ex.what()));
+				}
+			}
+
+			index = FindFreeIndex(hash);
+			if (_ctrl[index] == DELETED) {
+				_deleted--;
+			}
+
+			new (&_slots[index]) Node(std::move(key), value);
+			_ctrl[index] = H2(hash);
+			_elements++;
+		}
+
+		Node* Find(const K& key) {
+			size_t index = FindIndex(key, HashOf(key));
+			return index != _capacity ? &_slots[index] : nullptr;
+		}
+
+		const Node* Find(const K& key) const {
+			size_t index = FindIndex(key, HashOf(key));
+			return index != _capacity ? &_slots[index] : nullptr;
+		}
+
+		template <typename Q, EnableIfTransparent<Q> = 0>
+		Node* Find(const Q& key) {
+			size_t index = FindIndex(key, HashOf(key));
+			return index != _capacity ? &_slots[index] : nullptr;
+		}
+
+		template <typename Q, EnableIfTransparent<Q> = 0>
+		const Node* Find(const Q& key) const {
+			size_t index = FindIndex(key, HashOf(key));
+			return index != _capacity ? &_slots[index] : nullptr;
+		}
+
+		bool Contains(const K& key) const {
+			return Find(key) != nullptr;
+		}
+
+		template <typename Q, EnableIfTransparent<Q> = 0>
+		bool Contains(const Q& key) const {
+			return Find(key) != nullptr;
+		}
+
+		void Pop(const K& key) {
+			PopKey(key);
+		}
+
+		template <typename Q, EnableIfTransparent<Q> = 0>
+		void Pop(const Q& key) {
+			PopKey(key);
+		}
+
+		void Erase() {
+			for (size_t i = 0; i < _capacity; i++) {
+				if (_ctrl[i] >= 0) {
+					_slots[i].~Node();
+				}
+				_ctrl[i] = EMPTY;
+			}
+
+			_elements = 0;
+			_deleted = 0;
+		}
+
+		std::string ToString(unsigned int limit = 0, std::string(*out_to_string)(T) = nullptr) const {
+			if (limit <= 0 || limit > _elements) {
+				limit = int(_elements);
+			}
+
+			std::string text = ">>> Flat Hash Table <<<\n";
+			text += "> elements: " + std::to_string(int(_elements)) + "\n";
+			text += "> capacity: " + std::to_string(int(_capacity)) + "\n";
+			text += "> tombstones: " + std::to_string(int(_deleted)) + "\n";
+			text += "> load: " + std::to_string(CalculateLoad()) + "%\n";
+			text += "{\n";
+
+			if (out_to_string || std::is_arithmetic_v<T>) {
+				unsigned int shown = 0;
+				for (size_t i = 0; i < _capacity && shown < limit; i++) {
+					if (_ctrl[i] >= 0) {
+						text += std::to_string(i) + ": " + KeyToString(_slots[i].key) + " -> ";
+						if (out_to_string) {
+							text += out_to_string(_slots[i].value);
+						}
+						else if constexpr (std::is_arithmetic_v<T>) {
+							text += std::to_string(_slots[i].value);
+						}
+						text += "\n";
+						shown++;
+					}
+				}
+			}
+			else {
+				text = "T was not arithmetic and no cmp was provided\n";
+			}
+
+			if (limit < _elements) {
+				text += "[...]\n";
+			}
+
+			text += "}\n";
+
+			return text;
+		}
+	};
+
+	template <typename T, typename Hash = HF::Hash<std::string>>
+	using FlatHashTable = FlatHashMap<std::string, T, Hash>;
+
+	// Flat table for string keys that keeps no std::string per entry. The control byte is a 7-bit
+	// fingerprint checked before any key bytes. Keys of up to INLINE bytes are stored in the slot and
+	// compared with one memcmp; longer keys are appended to a table-owned arena and the slot holds
+	// their 32-bit offset and length. Arena bytes of popped keys are reclaimed on rehash.
+	template <typename T, typename Hash = HF::Hash<std::string>>
+	class CompactHashTable : Control {
+
+	public:
+		using Key = std::string;
+
+	private:
+		static constexpr size_t INLINE = 15;
+		static constexpr uint8_t LONG = 0xff;
+
+		struct Slot {
+			uint8_t size;
+			char bytes[INLINE];
+			T value;
+
+			Slot(T in_value) : size(0), value(std::move(in_value)) {}
+		};
+
+		const double FACTOR = 0.875;
+		Hash _hash;
+		int8_t* _ctrl;
+		Slot* _slots;
+		size_t _capacity;
+		size_t _elements;
+		size_t _deleted;
+		std::vector<char> _arena;
+		size_t _arena_dead;
+
+		uint64_t HashOf(std::string_view key) const {
+			return HF::Mix(_hash(key));
+		}
+
+		static uint32_t LongField(const Slot& slot, size_t field) {
+			uint32_t value;
+			std::memcpy(&value, slot.bytes + field * sizeof(uint32_t), sizeof(uint32_t));
+			return value;
+		}
+
+		std::string_view KeyOf(const Slot& slot) const {
+			if (slot.size != LONG) {
+				return std::string_view(slot.bytes, slot.size);
+			}
+			return std::string_view(_arena.data() + LongField(slot, 0), LongField(slot, 1));
+		}
+
+		bool Matches(const Slot& slot, std::string_view key) const {
+			if (key.size() <= INLINE) {
+				return slot.size == key.size() && (key.empty() || std::memcmp(slot.bytes, key.data(), key.size()) == 0);
+			}
+			return slot.size == LONG && LongField(slot, 1) == key.size() && std::memcmp(_arena.data() + LongField(slot, 0), key.data(), key.size()) == 0;
+		}
+
+		void StoreKey(Slot& slot, std::string_view key) {
+			if (key.size() <= INLINE) {
+				slot.size = uint8_t(key.size());
+				if (!key.empty()) {
+					std::memcpy(slot.bytes, key.data(), key.size());
+				}
+				return;
+			}
+
+			if (key.size() > UINT32_MAX - _arena.size()) {
+				throw std::length_error("FHT::StoreKey(): key arena is full");
+			}
+
+			uint32_t position[2] = { uint32_t(_arena.size()), uint32_t(key.size()) };
+			_arena.insert(_arena.end(), key.begin(), key.end());
+
+			slot.size = LONG;
+			std::memcpy(slot.bytes, position, sizeof(position));
+		}
+
+		size_t Groups() const {
+			return _capacity / GROUP;
+		}
+
+		size_t FindIndex(std::string_view key, uint64_t hash) const {
+			int8_t h2 = H2(hash);
+			size_t mask = Groups() - 1;
+			size_t group = size_t(hash) & mask;
+
+			for (size_t step = 1; step <= Groups(); step++) {
+				const int8_t* ctrl = _ctrl + group * GROUP;
+
+				for (uint32_t match = MatchByte(ctrl, h2); match; match &= match - 1) {
+					size_t index = group * GROUP + TrailingZeros(match);
+					if (Matches(_slots[index], key)) {
+						return index;
+					}
+				}
+
+				if (MatchByte(ctrl, EMPTY)) {
+					break;
+				}
+
+				group = (group + step) & mask;
+			}
+
+			return _capacity;
+		}
+
+		size_t FindFreeIndex(uint64_t hash) const {
+			size_t mask = Groups() - 1;
+			size_t group = size_t(hash) & mask;
+
+			for (size_t step = 1; step <= Groups(); step++) {
+				if (uint32_t free = MatchFree(_ctrl + group * GROUP)) {
+					return group * GROUP + TrailingZeros(free);
+				}
+
+				group = (group + step) & mask;
+			}
+
+			return _capacity;
+		}
+
+		void Allocate(size_t capacity) {
+			int8_t* ctrl = nullptr;
+
+			try {
+				ctrl = new int8_t[capacity];
+				_slots = static_cast<Slot*>(::operator new(capacity * sizeof(Slot)));
+			}
+			catch (const std::bad_alloc& ex) {
+				delete[] ctrl;
+				throw std::runtime_error("FHT::Allocate() -> " + std::string(ex.what()));
+			}
+
+			for (size_t i = 0; i < capacity; i++) {
+				ctrl[i] = EMPTY;
+			}
+
+			_ctrl = ctrl;
+			_capacity = capacity;
+			_deleted = 0;
+		}
+
+		// Also rewrites the arena without the keys of popped entries once they make up half of it.
+		void ReHash(size_t new_capacity) {
+			int8_t* old_ctrl = _ctrl;
+			Slot* old_slots = _slots;
+			size_t old_capacity = _capacity;
+
+			bool compact = _arena_dead && _arena_dead * 2 >= _arena.size();
+			std::vector<char> arena;
+
+			try {
+				if (compact) {
+					arena.reserve(_arena.size() - _arena_dead);
+				}
+				Allocate(new_capacity);
+			}
+			catch (const std::exception& ex) {
+				throw std::runtime_error("FHT::ReHash() -> " + std::string(ex.what()));
+			}
+
+			for (size_t i = 0; i < old_capacity; i++) {
+				if (old_ctrl[i] >= 0) {
+					std::string_view key = KeyOf(old_slots[i]);
+					uint64_t hash = HashOf(key);
+					size_t index = FindFreeIndex(hash);
+
+					new (&_slots[index]) Slot(std::move(old_slots[i]));
+					_ctrl[index] = H2(hash);
+					old_slots[i].~Slot();
+
+					if (compact && _slots[index].size == LONG) {
+						uint32_t offset = uint32_t(arena.size());
+						arena.insert(arena.end(), key.begin(), key.end());
+						std::memcpy(_slots[index].bytes, &offset, sizeof(offset));
+					}
+				}
+			}
+
+			if (compact) {
+				_arena.swap(arena);
+				_arena_dead = 0;
+			}
+
+			delete[] old_ctrl;
+			::operator delete(old_slots);
+		}
+
+		double CalculateLoad() const {
+			return 100 * double(_elements) / double(_capacity);
+		}
+
+	public:
+		CompactHashTable() : _ctrl(nullptr), _slots(nullptr), _capacity(0), _elements(0), _deleted(0), _arena_dead(0) {
+			try {
+				Allocate(1024);
+			}
+			catch (const std::exception& ex) {
+				throw std::runtime_error("FHT::CompactHashTable() -> " + std::string(ex.what()));
+			}
+		}
+
+		~CompactHashTable() {
+			Erase();
+			delete[] _ctrl;
+			::operator delete(_slots);
+		}
+
+		CompactHashTable(const CompactHashTable&) = delete;
+		CompactHashTable& operator=(const CompactHashTable&) = delete;
+
+		size_t Elements() const {
+			return _elements;
+		}
+
+		size_t Capacity() const {
+			return _capacity;
+		}
+
+		size_t Tombstones() const {
+			return _deleted;
+		}
+
+		size_t ArenaBytes() const {
+			return _arena.size();
+		}
+
+		void Push(std::string_view key, T value) {
+			uint64_t hash = HashOf(key);
+			size_t index = FindIndex(key, hash);
+
+			if (index != _capacity) {
+				_slots[index].value = value;
+				return;
+			}
+
+			try {
+				if (_elements + _deleted + 1 > _capacity * FACTOR) {
+					ReHash(_deleted > _elements / 2 ? _capacity : _capacity * 2);
+				}
+
+				index = FindFreeIndex(hash);
+				new (&_slots[index]) Slot(std::move(value));
+				try {
+					StoreKey(_slots[index], key);
+				}
+				catch (...) {
+					_slots[index].~Slot();
+					throw;
+				}
+			}
+			catch (const std::exception& ex) {
+				throw std::runtime_error("FHT::Push() -> " + std::string(ex.what()));
+			}
+
+			if (_ctrl[index] == DELETED) {
+				_deleted--;
+			}
+			_ctrl[index] = H2(hash);
+			_elements++;
+		}
+
+		T* Find(std::string_view key) {
+			size_t index = FindIndex(key, HashOf(key));
+			return index != _capacity ? &_slots[index].value : nullptr;
+		}
+
+		const T* Find(std::string_view key) const {
+			size_t index = FindIndex(key, HashOf(key));
+			return index != _capacity ? &_slots[index].value : nullptr;
+		}
+
+		bool Contains(std::string_view key) const {
+			return Find(key) != nullptr;
+		}
+
+		void Pop(std::string_view key) {
+			size_t index = FindIndex(key, HashOf(key));
+
+			if (index == _capacity) {
+				return;
+			}
+
+			if (_slots[index].size == LONG) {
+				_arena_dead += LongField(_slots[index], 1);
+			}
+			_slots[index].~Slot();
+
+			if (MatchByte(_ctrl + index / GROUP * GROUP, EMPTY)) {
+				_ctrl[index] = EMPTY;
+			}
+			else {
+				_ctrl[index] = DELETED;
+				_deleted++;
+			}
+
+			_elements--;
+		}
+
+		// Calls fn(std::string_view key, T& value) for every entry; the key view is valid until the next Push.
+		template <typename Function>
+		void ForEach(Function fn) {
+			for (size_t i = 0; i < _capacity; i++) {
+				if (_ctrl[i] >= 0) {
+					fn(KeyOf(_slots[i]), _slots[i].value);
+				}
+			}
+		}
+
+		void Erase() {
+			for (size_t i = 0; i < _capacity; i++) {
+				if (_ctrl[i] >= 0) {
+					_slots[i].~Slot();
+				}
+				_ctrl[i] = EMPTY;
+			}
+
+			_arena.clear();
+			_arena_dead = 0;
+			_elements = 0;
+			_deleted = 0;
+		}
+
+		std::string ToString(unsigned int limit = 0, std::string(*out_to_string)(T) = nullptr) const {
+			if (limit <= 0 || limit > _elements) {
+				limit = int(_elements);
+			}
+
+			std::string text = ">>> Compact Hash Table <<<\n";
+			text += "> elements: " + std::to_string(int(_elements)) + "\n";
+			text += "> capacity: " + std::to_string(int(_capacity)) + "\n";
+			text += "> tombstones: " + std::to_string(int(_deleted)) + "\n";
+			text += "> load: " + std::to_string(CalculateLoad()) + "%\n";
+			text += "> arena: " + std::to_string(_arena.size()) + " bytes (" + std::to_string(_arena_dead) + " dead)\n";
+			text += "{\n";
+
+			if (out_to_string || std::is_arithmetic_v<T>) {
+				unsigned int shown = 0;
+				for (size_t i = 0; i < _capacity && shown < limit; i++) {
+					if (_ctrl[i] >= 0) {
+						text += std::to_string(i) + ": " + std::string(KeyOf(_slots[i])) + " -> ";
+						if (out_to_string) {
+							text += out_to_string(_slots[i].value);
+						}
+						else if constexpr (std::is_arithmetic_v<T>) {
+							text += std::to_string(_slots[i].value);
+						}
+						text += "\n";
+						shown++;
+					}
+				}
+			}
+			else {
+				text = "T was not arithmetic and no cmp was provided\n";
+			}
+
+			if (limit < _elements) {
+				text += "[...]\n";
+			}
+
+			text += "}\n";
+
+			return text;
+		}
+	};
+}
\ No newline at end of file
@@ -0,0 +1,173 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <type_traits>
+
+#if defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h>
+#endif
+
+namespace HF {
+
+	inline uint64_t Mix(uint64_t hash) {
+		hash ^= hash >> 33;
+		hash *= 0xff51afd7ed558ccdull;
+		hash ^= hash >> 33;
+		hash *= 0xc4ceb9fe1a85ec53ull;
+		hash ^= hash >> 33;
+
+		return hash;
+	}
+
+	struct Polynomial {
+		using is_transparent = void;
+
+		uint64_t operator()(std::string_view key) const {
+			uint64_t hash = 0;
+
+			for (unsigned char c : key) {
+				hash = hash * 31 + c;
+			}
+
+			return hash;
+		}
+	};
+
+	struct FNV1a {
+		using is_transparent = void;
+
+		uint64_t operator()(std::string_view key) const {
+			uint64_t hash = 14695981039346656037ull;
+
+			for (unsigned char c : key) {
+				hash ^= c;
+				hash *= 1099511628211ull;
+			}
+
+			return hash;
+		}
+	};
+
+	struct WyHash {
+		using is_transparent = void;
+
+		static constexpr uint64_t SECRET[4] = { 0xa0761d6478bd642full, 0xe7037ed1a0b428dbull, 0x8ebc6af09c88c6dbull, 0x589965cc75374cc3ull };
+
+		static void Multiply(uint64_t& a, uint64_t& b) {
+#if defined(__SIZEOF_INT128__)
+			__uint128_t r = __uint128_t(a) * b;
+			a = uint64_t(r);
+			b = uint64_t(r >> 64);
+#elif defined(_MSC_VER) && defined(_M_X64)
+			a = _umul128(a, b, &b);
+#else
+			uint64_t ha = a >> 32, hb = b >> 32, la = uint32_t(a), lb = uint32_t(b);
+			uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+			uint64_t t = rl + (rm0 << 32);
+			uint64_t c = t < rl;
+			uint64_t lo = t + (rm1 << 32);
+			c += lo < t;
+			a = lo;
+			b = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+#endif
+		}
+
+		static uint64_t Fold(uint64_t a, uint64_t b) {
+			Multiply(a, b);
+			return a ^ b;
+		}
+
+		static uint64_t Read8(const unsigned char* p) {
+			uint64_t v;
+			std::memcpy(&v, p, 8);
+			return v;
+		}
+
+		static uint64_t Read4(const unsigned char* p) {
+			uint32_t v;
+			std::memcpy(&v, p, 4);
+			return v;
+		}
+
+		static uint64_t Read3(const unsigned char* p, size_t len) {
+			return (uint64_t(p[0]) << 16) | (uint64_t(p[len >> 1]) << 8) | p[len - 1];
+		}
+
+		uint64_t operator()(std::string_view key) const {
+			const unsigned char* p = reinterpret_cast<const unsigned char*>(key.data());
+			size_t len = key.size();
+			uint64_t seed = SECRET[0] ^ Fold(SECRET[0], SECRET[1]);
+			uint64_t a = 0;
+			uint64_t b = 0;
+
+			if (len <= 16) {
+				if (len >= 4) {
+					a = (Read4(p) << 32) | Read4(p + ((len >> 3) << 2));
+					b = (Read4(p + len - 4) << 32) | Read4(p + len - 4 - ((len >> 3) << 2));
+				}
+				else if (len > 0) {
+					a = Read3(p, len);
+				}
+			}
+			else {
+				size_t i = len;
+
+				while (i > 16) {
+					seed = Fold(Read8(p) ^ SECRET[1], Read8(p + 8) ^ seed);
+					p += 16;
+					i -= 16;
+				}
+
+				a = Read8(p + i - 16);
+				b = Read8(p + i - 8);
+			}
+
+			a ^= SECRET[1];
+			b ^= seed;
+			Multiply(a, b);
+
+			return Fold(a ^ SECRET[0] ^ len, b ^ SECRET[1]);
+		}
+	};
+
+	template <typename K, typename = void>
+	struct Hash {
+		uint64_t operator()(const K& key) const {
+			return Mix(uint64_t(std::hash<K>{}(key)));
+		}
+	};
+
+	template <typename K>
+	struct Hash<K, std::enable_if_t<std::is_integral_v<K> || std::is_enum_v<K>>> {
+		uint64_t operator()(K key) const {
+			return Mix(uint64_t(key));
+		}
+	};
+
+	template <>
+	struct Hash<std::string> : WyHash {};
+
+	template <>
+	struct Hash<std::string_view> : WyHash {};
+
+	template <typename K>
+	struct Equal : std::equal_to<K> {};
+
+	template <>
+	struct Equal<std::string> {
+		using is_transparent = void;
+
+		bool operator()(std::string_view a, std::string_view b) const {
+			return a == b;
+		}
+	};
+
+	template <typename Hash, typename KeyEqual, typename = void>
+	struct IsTransparent : std::false_type {};
+
+	template <typename Hash, typename KeyEqual>
+	struct IsTransparent<Hash, KeyEqual, std::void_t<typename Hash::is_transparent, typename KeyEqual::is_transparent>> : std::true_type {};
+}
\ No newline at end of file
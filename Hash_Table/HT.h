@@ -1,149 +1,1356 @@
 #pragma once
 #include <string>
-#include <cmath>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+#include <cstddef>
+#include <iterator>
+#include <exception>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <utility>
+#include <algorithm>
 #include "DLL.h"
 #include "DA.h"
+#include "HF.h"
+#include "POOL.h"
+#include "PHT.h"
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <xmmintrin.h>
+#endif
 
 namespace HT {
 
-	template <typename T>
-	class HashTable {
+	inline void Prefetch(const void* ptr) {
+#if defined(__GNUC__) || defined(__clang__)
+		__builtin_prefetch(ptr);
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+		_mm_prefetch(static_cast<const char*>(ptr), _MM_HINT_T0);
+#else
+		(void)ptr;
+#endif
+	}
+
+	struct ListChaining {
+		static constexpr bool INTRUSIVE = false;
+
+		template <typename T>
+		using List = DLL::DoubLinList<T>;
+	};
+
+	// Buckets are unrolled lists, so a chain of a few nodes sits in one cache line.
+	struct UnrolledChaining {
+		static constexpr bool INTRUSIVE = false;
+
+		template <typename T>
+		using List = DLL::DoubLinList<T, DLL::Unrolled<>>;
+	};
+
+	struct IntrusiveChaining {
+		static constexpr bool INTRUSIVE = true;
+
+		template <typename T>
+		using List = DLL::DoubLinList<T>;
+	};
+
+	struct NoStats {
+		static constexpr bool ENABLED = false;
+
+		void OnChain(size_t, size_t) {}
+		void OnChainsReset() {}
+		void OnFind(size_t, bool) const {}
+		void OnFilter() const {}
+		void OnReHash() {}
+		void OnReHashTime(double) {}
+		void OnAllocate(size_t = 1) {}
+	};
+
+	class LiveStats {
+		static void Add(std::atomic<uint64_t>& counter, uint64_t value) {
+			counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+		}
+
+	public:
+		static constexpr bool ENABLED = true;
+		static constexpr size_t HISTOGRAM = 64;
+
+	private:
+		size_t histogram[HISTOGRAM] = {};
+		size_t longest = 0;
+		mutable std::atomic<uint64_t> hits{ 0 };
+		mutable std::atomic<uint64_t> hit_probes{ 0 };
+		mutable std::atomic<uint64_t> misses{ 0 };
+		mutable std::atomic<uint64_t> miss_probes{ 0 };
+		mutable std::atomic<uint64_t> filtered{ 0 };
+		uint64_t rehashes = 0;
+		double rehash_time = 0.0;
+		uint64_t allocations = 0;
+
+		static size_t Bin(size_t length) {
+			return length < HISTOGRAM - 1 ? length : HISTOGRAM - 1;
+		}
+
+	public:
+		void OnChain(size_t from, size_t to) {
+			if (from) {
+				histogram[Bin(from)]--;
+			}
+			if (to) {
+				histogram[Bin(to)]++;
+			}
+
+			if (to > longest) {
+				longest = to;
+			}
+			else if (from == longest && to < from && !histogram[Bin(from)]) {
+				while (longest && !histogram[Bin(longest)]) {
+					longest--;
+				}
+			}
+		}
+
+		void OnChainsReset() {
+			for (size_t& count : histogram) {
+				count = 0;
+			}
+			longest = 0;
+		}
+
+		void OnFind(size_t probes, bool hit) const {
+			if (hit) {
+				Add(hits, 1);
+				Add(hit_probes, probes);
+			}
+			else {
+				Add(misses, 1);
+				Add(miss_probes, probes);
+			}
+		}
+
+		// A lookup the filter answered without touching a bucket; it is not counted as a miss.
+		void OnFilter() const {
+			Add(filtered, 1);
+		}
+
+		void OnReHash() {
+			rehashes++;
+		}
+
+		void OnReHashTime(double seconds) {
+			rehash_time += seconds;
+		}
+
+		void OnAllocate(size_t count = 1) {
+			allocations += count;
+		}
+
+		size_t Chains(size_t length) const {
+			return length < HISTOGRAM ? histogram[length] : 0;
+		}
+
+		size_t ShortestChain() const {
+			for (size_t i = 1; i < HISTOGRAM; i++) {
+				if (histogram[i]) {
+					return i;
+				}
+			}
+			return 0;
+		}
+
+		size_t LongestChain() const {
+			return longest;
+		}
+
+		uint64_t Hits() const {
+			return hits.load(std::memory_order_relaxed);
+		}
+
+		uint64_t Misses() const {
+			return misses.load(std::memory_order_relaxed);
+		}
+
+		double ProbesPerHit() const {
+			uint64_t count = Hits();
+			return count ? double(hit_probes.load(std::memory_order_relaxed)) / double(count) : 0.0;
+		}
+
+		double ProbesPerMiss() const {
+			uint64_t count = Misses();
+			return count ? double(miss_probes.load(std::memory_order_relaxed)) / double(count) : 0.0;
+		}
 
+		uint64_t Filtered() const {
+			return filtered.load(std::memory_order_relaxed);
+		}
+
+		// Share of absent keys that got past the filter and walked a bucket.
+		double FalsePositiveRate() const {
+			uint64_t passed = Misses();
+			return passed + Filtered() ? double(passed) / double(passed + Filtered()) : 0.0;
+		}
+
+		uint64_t ReHashes() const {
+			return rehashes;
+		}
+
+		double ReHashTime() const {
+			return rehash_time;
+		}
+
+		uint64_t Allocations() const {
+			return allocations;
+		}
+
+		std::string ToString() const {
+			std::string text = "> longest chain: " + std::to_string(longest) + "\n";
+			text += "> chains by length:";
+			for (size_t i = 1; i < HISTOGRAM; i++) {
+				if (histogram[i]) {
+					text += " " + std::to_string(i) + (i == HISTOGRAM - 1 ? "+" : "") + ":" + std::to_string(histogram[i]);
+				}
+			}
+			text += "\n";
+			text += "> probes per hit: " + std::to_string(ProbesPerHit()) + " (" + std::to_string(Hits()) + " hits)\n";
+			text += "> probes per miss: " + std::to_string(ProbesPerMiss()) + " (" + std::to_string(Misses()) + " misses)\n";
+			if (Filtered()) {
+				text += "> filtered: " + std::to_string(Filtered()) + " (false positive rate " + std::to_string(FalsePositiveRate()) + ")\n";
+			}
+			text += "> rehashes: " + std::to_string(rehashes) + " (" + std::to_string(rehash_time) + "s)\n";
+			text += "> allocations: " + std::to_string(allocations) + "\n";
+
+			return text;
+		}
+	};
+
+	struct NoFilter {
+		static constexpr bool ENABLED = false;
+
+		void Resize(size_t) {}
+		void Add(uint64_t) {}
+		void Remove(uint64_t) {}
+		bool MayContain(uint64_t) const { return true; }
+		const void* BlockOf(uint64_t) const { return nullptr; }
+	};
+
+	// Counting Bloom filter over the stored 64-bit hashes. Each hash maps to one 64-byte block of 128
+	// four-bit counters and sets PROBES of them, so a negative answer costs one cache line. Counters
+	// saturate at 15 and are never decremented after that, which keeps removal free of false negatives.
+	class BloomFilter {
+		static constexpr size_t PROBES = 4;
+		static constexpr size_t CELL_BITS = 7;
+		static constexpr size_t BUCKETS_PER_BLOCK = 16;
+		static constexpr uint64_t SATURATED = 15;
+
+		struct alignas(64) Block {
+			uint64_t words[8] = {};
+		};
+
+		std::vector<Block> blocks;
+
+		Block& Locate(uint64_t hash) {
+			return blocks[size_t(hash >> 32) & (blocks.size() - 1)];
+		}
+
+		const Block& Locate(uint64_t hash) const {
+			return blocks[size_t(hash >> 32) & (blocks.size() - 1)];
+		}
+
+		static uint64_t Counter(const Block& block, size_t cell) {
+			return (block.words[cell / 16] >> (cell % 16 * 4)) & 15;
+		}
+
+		// The low hash bits pick the table bucket and the high half picks the block, so cells come from
+		// the top of hash times an odd constant, which depends on every bit and on neither choice alone.
+		static uint64_t Cells(uint64_t hash) {
+			return hash * 0x9e3779b97f4a7c15ull;
+		}
+
+		static size_t Cell(uint64_t cells, size_t probe) {
+			return size_t(cells >> (64 - (probe + 1) * CELL_BITS)) & 127;
+		}
+
+	public:
+		static constexpr bool ENABLED = true;
+
+		// Sizes the filter for a bucket array of the given capacity and clears it.
+		void Resize(size_t buckets) {
+			size_t count = buckets / BUCKETS_PER_BLOCK ? buckets / BUCKETS_PER_BLOCK : 1;
+			blocks.assign(count, Block());
+		}
+
+		void Add(uint64_t hash) {
+			Block& block = Locate(hash);
+			uint64_t cells = Cells(hash);
+			for (size_t probe = 0; probe < PROBES; probe++) {
+				size_t cell = Cell(cells, probe);
+				if (Counter(block, cell) != SATURATED) {
+					block.words[cell / 16] += uint64_t(1) << (cell % 16 * 4);
+				}
+			}
+		}
+
+		void Remove(uint64_t hash) {
+			Block& block = Locate(hash);
+			uint64_t cells = Cells(hash);
+			for (size_t probe = 0; probe < PROBES; probe++) {
+				size_t cell = Cell(cells, probe);
+				uint64_t counter = Counter(block, cell);
+				if (counter != SATURATED && counter) {
+					block.words[cell / 16] -= uint64_t(1) << (cell % 16 * 4);
+				}
+			}
+		}
+
+		bool MayContain(uint64_t hash) const {
+			const Block& block = Locate(hash);
+			uint64_t cells = Cells(hash);
+			for (size_t probe = 0; probe < PROBES; probe++) {
+				if (!Counter(block, Cell(cells, probe))) {
+					return false;
+				}
+			}
+			return true;
+		}
+
+		const void* BlockOf(uint64_t hash) const {
+			return &Locate(hash);
+		}
+	};
+
+	template <typename Node, bool INTRUSIVE, bool COUNTED>
+	struct NodeLink {};
+
+	template <typename Node>
+	struct NodeLink<Node, true, false> {
+		Node* next = nullptr;
+	};
+
+	// With live stats the head node of an intrusive chain holds the chain length, so keeping the
+	// histogram never walks a chain.
+	template <typename Node>
+	struct NodeLink<Node, true, true> {
+		Node* next = nullptr;
+		size_t chain = 0;
+	};
+
+	template <typename K, typename T, typename Hash = HF::Hash<K>, typename KeyEqual = HF::Equal<K>, typename Chaining = ListChaining, typename Stats = NoStats, typename Filter = NoFilter>
+	class HashMap {
+
+	public:
 		struct Node;
 
+	private:
+		using List = typename Chaining::template List<Node*>;
+		using Slot = std::conditional_t<Chaining::INTRUSIVE, Node*, List*>;
+
+		template <typename Q>
+		using EnableIfTransparent = std::enable_if_t<!std::is_void_v<Q> && HF::IsTransparent<Hash, KeyEqual>::value, int>;
+
+		static constexpr size_t BATCH = 16;
+
 		const double FACTOR = 0.75;
-		DA::DynArr<DLL::DoubLinList<Node*>*>* _array;
+		const double SHRINK_FACTOR = 0.1875;
+		Hash _hash;
+		KeyEqual _equal;
+		Stats _stats;
+		Filter _filter;
+		POOL::Pool<Node> _node_pool;
+		POOL::Pool<List> _list_pool;
+		typename List::NodePool _list_node_pool;
+		DA::DynArr<Slot>* _array;
+		DA::DynArr<Slot>* _old_array;
+		size_t _migrated;
+		size_t _rehash_step;
+		size_t _min_capacity;
 		size_t _lists;
 		size_t _elements;
 
-		size_t GetHashIndex(std::string key) const {
-			size_t index = 0;
-			unsigned int q = key.length();
+		template <typename Q>
+		uint64_t GetHash(const Q& key) const {
+			return _hash(key);
+		}
+
+		static size_t GetHashIndex(uint64_t hash, size_t capacity) {
+			return size_t(hash) & (capacity - 1);
+		}
+
+		template <typename Q>
+		bool Matches(const Node* node, uint64_t hash, const Q& key) const {
+			if constexpr (std::is_integral_v<K> && std::is_integral_v<Q>) {
+				return node->key == key;
+			}
+			else {
+				return node->hash == hash && _equal(node->key, key);
+			}
+		}
+
+		template <typename Q>
+		Node* BucketFind(Slot slot, uint64_t hash, const Q& key, size_t& probes) const {
+			if (!slot) {
+				return nullptr;
+			}
+
+			if constexpr (Chaining::INTRUSIVE) {
+				for (Node* node = slot; node; node = node->next) {
+					probes++;
+					if (Matches(node, hash, key)) {
+						return node;
+					}
+				}
+				return nullptr;
+			}
+			else {
+				auto found = slot->FindIf([this, hash, &key, &probes](Node* node) { probes++; return Matches(node, hash, key); });
+				return found ? List::At(found) : nullptr;
+			}
+		}
+
+		void BucketPush(Slot& slot, Node* node) {
+			size_t size = 0;
+			if constexpr (Stats::ENABLED) {
+				size = BucketSize(slot);
+			}
+
+			if constexpr (Chaining::INTRUSIVE) {
+				if (!slot) {
+					_lists++;
+				}
+				if constexpr (Stats::ENABLED) {
+					node->chain = size + 1;
+				}
+				node->next = slot;
+				slot = node;
+			}
+			else {
+				if (!slot) {
+					slot = _list_pool.New(&_list_node_pool);
+					_stats.OnAllocate();
+					_lists++;
+				}
+
+				try {
+					slot->Push(node);
+				}
+				catch (const std::exception& ex) {
+					throw std::runtime_error("HT::BucketPush() -> " + std::string(ex.what()));
+				}
+			}
+
+			_stats.OnChain(size, size + 1);
+		}
+
+		template <typename Q>
+		Node* BucketRemove(Slot& slot, uint64_t hash, const Q& key) {
+			if (!slot) {
+				return nullptr;
+			}
+
+			Node* removed = nullptr;
+			size_t size = 0;
+			if constexpr (Stats::ENABLED) {
+				size = BucketSize(slot);
+			}
+
+			if constexpr (Chaining::INTRUSIVE) {
+				for (Node** link = &slot; *link; link = &(*link)->next) {
+					if (Matches(*link, hash, key)) {
+						removed = *link;
+						*link = removed->next;
+						break;
+					}
+				}
+				if constexpr (Stats::ENABLED) {
+					if (removed && slot) {
+						slot->chain = size - 1;
+					}
+				}
+			}
+			else {
+				try {
+					slot->RemoveIf([this, hash, &key, &removed](Node* node) { return Matches(node, hash, key) && (removed = node); });
+				}
+				catch (const std::exception& ex) {
+					throw std::runtime_error("HT::BucketRemove() -> " + std::string(ex.what()));
+				}
+
+				if (slot->Size() == 0) {
+					_list_pool.Delete(slot);
+					slot = nullptr;
+				}
+			}
+
+			if (!slot) {
+				_lists--;
+			}
+
+			if (removed) {
+				_stats.OnChain(size, size - 1);
+			}
+
+			return removed;
+		}
+
+		size_t BucketSize(Slot slot) const {
+			if constexpr (Chaining::INTRUSIVE && Stats::ENABLED) {
+				return slot ? slot->chain : 0;
+			}
+			else if constexpr (Chaining::INTRUSIVE) {
+				size_t size = 0;
+				for (Node* node = slot; node; node = node->next) {
+					size++;
+				}
+				return size;
+			}
+			else {
+				return slot ? slot->Size() : 0;
+			}
+		}
+
+		template <typename Function>
+		static void BucketForEach(Slot slot, Function fn) {
+			if constexpr (Chaining::INTRUSIVE) {
+				for (Node* node = slot; node;) {
+					Node* next = node->next;
+					fn(node);
+					node = next;
+				}
+			}
+			else if (slot) {
+				slot->ForEach(fn);
+			}
+		}
+
+		void BucketRelease(Slot& slot) {
+			if constexpr (!Chaining::INTRUSIVE) {
+				_list_pool.Delete(slot);
+			}
+			slot = nullptr;
+			_lists--;
+		}
+
+		void StartReHash(size_t capacity) {
+			try {
+				_old_array = _array;
+				_array = new DA::DynArr<Slot>(capacity, nullptr);
+			}
+			catch (const std::bad_alloc& ex) {
+				_array = _old_array;
+				_old_array = nullptr;
+				throw std::runtime_error("HT::StartReHash() -> " + std::string(ex.what()));
+			}
+
+			_stats.OnReHash();
+			_stats.OnAllocate();
+			_migrated = 0;
+
+			RebuildFilter();
+		}
+
+		void MigrateBuckets(size_t count) {
+			Timer timer(_stats);
+			size_t end = _old_array->Capacity();
+			if (count < end - _migrated) {
+				end = _migrated + count;
+			}
+
+			try {
+				for (; _migrated < end; _migrated++) {
+					if (Slot& slot = (*_old_array)[_migrated]) {
+						if constexpr (Stats::ENABLED) {
+							_stats.OnChain(BucketSize(slot), 0);
+						}
+						BucketForEach(slot, [this](Node* node) { PasteNode(node); });
+						BucketRelease(slot);
+					}
+				}
+			}
+			catch (const std::exception& ex) {
+				throw std::runtime_error("HT::MigrateBuckets() -> " + std::string(ex.what()));
+			}
+
+			if (_migrated == _old_array->Capacity()) {
+				delete _old_array;
+				_old_array = nullptr;
+			}
+		}
+
+		class Timer {
+			Stats& stats;
+			std::chrono::steady_clock::time_point start;
+
+		public:
+			Timer(Stats& in_stats) : stats(in_stats) {
+				if constexpr (Stats::ENABLED) {
+					start = std::chrono::steady_clock::now();
+				}
+			}
+
+			~Timer() {
+				if constexpr (Stats::ENABLED) {
+					stats.OnReHashTime(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+				}
+			}
+		};
+
+		void CountChains() {
+			if constexpr (Stats::ENABLED) {
+				_stats.OnChainsReset();
+
+				for (const DA::DynArr<Slot>* array : { _array, _old_array }) {
+					if (array) {
+						for (Slot slot : *array) {
+							if (slot) {
+								_stats.OnChain(0, BucketSize(slot));
+							}
+						}
+					}
+				}
+			}
+		}
+
+		// The filter is sized with the bucket array, so it is refilled whenever an array is replaced. If
+		// it cannot grow, the old one is kept: it still covers every stored hash, only less sharply.
+		void RebuildFilter() {
+			if constexpr (Filter::ENABLED) {
+				size_t capacity = _array->Capacity();
+				if (_old_array && _old_array->Capacity() > capacity) {
+					capacity = _old_array->Capacity();
+				}
+
+				try {
+					_filter.Resize(capacity);
+				}
+				catch (const std::bad_alloc&) {
+					return;
+				}
+				_stats.OnAllocate();
+
+				for (const DA::DynArr<Slot>* array : { _array, _old_array }) {
+					if (array) {
+						for (Slot slot : *array) {
+							BucketForEach(slot, [this](Node* node) { _filter.Add(node->hash); });
+						}
+					}
+				}
+			}
+		}
+
+		size_t CapacityFor(size_t elements) const {
+			size_t capacity = 1024;
+			while (capacity * FACTOR < elements) {
+				capacity *= 2;
+			}
+			return capacity;
+		}
+
+		void ExpandAndReHash() {
+			try {
+				ReHash(_array->Factor() * _array->Capacity());
+			}
+			catch (const std::exception& ex) {
+				throw std::runtime_error("HT::ExpandAndReHash() -> " + std::string(ex.what()));
+			}
+		}
+
+		void ReHash(size_t capacity) {
+			Timer timer(_stats);
+			DA::DynArr<Slot>* new_array;
+
+			try {
+				new_array = new DA::DynArr<Slot>(capacity, nullptr);
+			}
+			catch (const std::bad_alloc& ex) {
+				throw std::runtime_error("HT::ReHash() -> " + std::string(ex.what()));
+			}
+
+			DA::DynArr<Slot>* old_array = _array;
+
+			_array = new_array;
+			_lists = 0;
+
+			_stats.OnReHash();
+			_stats.OnAllocate();
+			_stats.OnChainsReset();
+
+			try {
+				for (Slot slot : *old_array) {
+					if (slot) {
+						BucketForEach(slot, [this](Node* node) { PasteNode(node); });
+						if constexpr (!Chaining::INTRUSIVE) {
+							_list_pool.Delete(slot);
+						}
+					}
+				}
+			}
+			catch (const std::exception& ex) {
+				throw std::runtime_error("HT::ReHash() -> " + std::string(ex.what()));
+			}
+			
+			delete old_array;
+
+			RebuildFilter();
+		}
+
+		void PasteNode(Node* node) {
+			size_t index = GetHashIndex(node->hash, _array->Capacity());
+
+			try {
+				BucketPush((*_array)[index], node);
+			}
+			catch (const std::exception& ex) {
+				throw std::runtime_error("HT::PasteNode() -> " + std::string(ex.what()));
+			}
+		}
+
+		template <typename Q>
+		Node* FindInArray(const DA::DynArr<Slot>* array, uint64_t hash, const Q& key, size_t& probes) const {
+			return BucketFind((*array)[GetHashIndex(hash, array->Capacity())], hash, key, probes);
+		}
+
+		template <typename Q>
+		bool PopFromArray(DA::DynArr<Slot>* array, uint64_t hash, const Q& key) {
+			Node* removed = BucketRemove((*array)[GetHashIndex(hash, array->Capacity())], hash, key);
+
+			_node_pool.Delete(removed);
+			return removed != nullptr;
+		}
+
+		double CalculateArrayLoad() const {
+			if (_lists) {
+				return 100 / (double(_array->Capacity()) / double(_lists));
+			}
+			return 0;
+		}
+
+		double CalculateListElementMinCount() const {
+			double min = 0.0;
+
+			for (const DA::DynArr<Slot>* array : { _array, _old_array }) {
+				if (!array) {
+					continue;
+				}
+				for (Slot slot : *array) {
+					if (slot) {
+						size_t size = BucketSize(slot);
+						if (!min || size < min) {
+							min = double(size);
+						}
+					}
+				}
+			}
+
+			return min;
+		}
+
+		double CalculateListElementMaxCount() const {
+			size_t max = 0;
+
+			for (const DA::DynArr<Slot>* array : { _array, _old_array }) {
+				if (!array) {
+					continue;
+				}
+				for (Slot slot : *array) {
+					if (slot && BucketSize(slot) > max) {
+						max = BucketSize(slot);
+					}
+				}
+			}
+
+			return max;
+		}
+
+		double CalculateListElementAvgCount() const {
+			if (_lists) {
+				return double(_elements) / double(_lists);
+			}
+			return 0;
+		}
+
+		static std::string KeyToString(const K& key) {
+			if constexpr (std::is_convertible_v<const K&, std::string>) {
+				return key;
+			}
+			else if constexpr (std::is_arithmetic_v<K>) {
+				return std::to_string(key);
+			}
+			else {
+				return "?";
+			}
+		}
+
+		template <typename Q>
+		Node* FindKey(const Q& key) const {
+			uint64_t hash = GetHash(key);
+			if (!_filter.MayContain(hash)) {
+				_stats.OnFilter();
+				return nullptr;
+			}
+
+			size_t probes = 0;
+			Node* found = FindHashed(hash, key, probes);
+
+			_stats.OnFind(probes, found != nullptr);
+			return found;
+		}
+
+		template <typename Q>
+		Node* FindHashed(uint64_t hash, const Q& key, size_t& probes) const {
+			if (Node* found = FindInArray(_array, hash, key, probes)) {
+				return found;
+			}
+			if (_old_array) {
+				return FindInArray(_old_array, hash, key, probes);
+			}
+
+			return nullptr;
+		}
+
+		template <typename Q>
+		void FindBatchKeys(const Q* keys, size_t count, Node** out) const {
+			uint64_t hashes[BATCH];
+			Slot slots[BATCH];
+			bool passed[BATCH];
+
+			for (size_t start = 0; start < count; start += BATCH) {
+				size_t n = count - start < BATCH ? count - start : BATCH;
+				const Q* batch_keys = keys + start;
+				Node** batch_out = out + start;
+
+				for (size_t i = 0; i < n; i++) {
+					hashes[i] = GetHash(batch_keys[i]);
+					if constexpr (Filter::ENABLED) {
+						Prefetch(_filter.BlockOf(hashes[i]));
+					}
+					Prefetch(&(*_array)[GetHashIndex(hashes[i], _array->Capacity())]);
+				}
+
+				for (size_t i = 0; i < n; i++) {
+					passed[i] = _filter.MayContain(hashes[i]);
+					slots[i] = passed[i] ? (*_array)[GetHashIndex(hashes[i], _array->Capacity())] : nullptr;
+					if (slots[i]) {
+						Prefetch(slots[i]);
+					}
+				}
+
+				if constexpr (!Chaining::INTRUSIVE) {
+					for (size_t i = 0; i < n; i++) {
+						if (slots[i]) {
+							Prefetch(slots[i]->Front());
+						}
+					}
+
+					for (size_t i = 0; i < n; i++) {
+						if (slots[i]) {
+							Prefetch(List::At(slots[i]->First()));
+						}
+					}
+				}
 
-			for (int i = 0; i < q; i++) {
-				index += key[i] * std::pow(31, q - (i + 1));
+				for (size_t i = 0; i < n; i++) {
+					if (!passed[i]) {
+						batch_out[i] = nullptr;
+						_stats.OnFilter();
+						continue;
+					}
+
+					size_t probes = 0;
+					batch_out[i] = BucketFind(slots[i], hashes[i], batch_keys[i], probes);
+					if (!batch_out[i] && _old_array) {
+						batch_out[i] = FindInArray(_old_array, hashes[i], batch_keys[i], probes);
+					}
+					_stats.OnFind(probes, batch_out[i] != nullptr);
+				}
+			}
+		}
+
+		// Looks the key up once and builds the node only when it is missing, so args are left
+		// untouched when the key already exists.
+		template <typename KArg, typename... Args>
+		std::pair<Node*, bool> TryEmplaceHashed(uint64_t hash, KArg&& key, Args&&... args) {
+			if (_old_array) {
+				MigrateBuckets(_rehash_step ? _rehash_step : _old_array->Capacity());
+			}
+
+			size_t probes = 0;
+			if (_filter.MayContain(hash)) {
+				if (Node* existing_node = FindHashed(hash, key, probes)) {
+					return { existing_node, false };
+				}
+			}
+
+			Node* node = _node_pool.New(hash, std::forward<KArg>(key), std::forward<Args>(args)...);
+			_stats.OnAllocate();
+
+			try {
+				BucketPush((*_array)[GetHashIndex(hash, _array->Capacity())], node);
+				_elements++;
+			}
+			catch (...) {
+				_node_pool.Delete(node);
+				throw;
+			}
+			_filter.Add(hash);
+
+			if (_elements > (*_array).Capacity() * FACTOR) {
+				if (_old_array) {
+					MigrateBuckets(_old_array->Capacity());
+				}
+
+				if (_rehash_step) {
+					StartReHash(_array->Factor() * _array->Capacity());
+				}
+				else {
+					ExpandAndReHash();
+				}
+			}
+
+			return { node, true };
+		}
+
+		template <typename KArg, typename M>
+		std::pair<Node*, bool> InsertOrAssignHashed(uint64_t hash, KArg&& key, M&& value) {
+			auto result = TryEmplaceHashed(hash, std::forward<KArg>(key), std::forward<M>(value));
+			if (!result.second) {
+				result.first->value = std::forward<M>(value);
+			}
+
+			return result;
+		}
+
+		struct alignas(64) Builder {
+			POOL::Pool<Node> node_pool;
+			POOL::Pool<List> list_pool;
+			typename List::NodePool list_node_pool;
+			std::vector<std::vector<size_t>> parts;
+			size_t lists = 0;
+			size_t elements = 0;
+			std::exception_ptr error;
+		};
+
+		// The caller still owns node if this throws.
+		static void LinkNode(Builder& builder, Slot& slot, Node* node) {
+			if constexpr (Chaining::INTRUSIVE) {
+				if (!slot) {
+					builder.lists++;
+				}
+				if constexpr (Stats::ENABLED) {
+					node->chain = slot ? slot->chain + 1 : 1;
+				}
+				node->next = slot;
+				slot = node;
+			}
+			else {
+				if (!slot) {
+					slot = builder.list_pool.New(&builder.list_node_pool);
+					builder.lists++;
+				}
+				slot->Push(node);
+			}
+
+			builder.elements++;
+		}
+
+		template <typename Iterator>
+		void HashPart(Iterator first, std::vector<uint64_t>& hashes, size_t begin, size_t end, size_t buckets_per_thread, Builder& builder) const {
+			try {
+				for (size_t i = begin; i < end; i++) {
+					hashes[i] = GetHash(first[i].first);
+					builder.parts[GetHashIndex(hashes[i], _array->Capacity()) / buckets_per_thread].push_back(i);
+				}
+			}
+			catch (...) {
+				builder.error = std::current_exception();
+			}
+		}
+
+		template <typename Iterator>
+		void LinkPart(Iterator first, const std::vector<uint64_t>& hashes, std::vector<Builder>& builders, size_t owner, size_t buckets_per_thread) {
+			Builder& builder = builders[owner];
+
+			try {
+				for (Builder& source : builders) {
+					for (size_t i : source.parts[owner]) {
+						const auto& item = first[i];
+						Slot& slot = (*_array)[GetHashIndex(hashes[i], _array->Capacity())];
+
+						size_t probes = 0;
+						if (Node* existing_node = BucketFind(slot, hashes[i], item.first, probes)) {
+							existing_node->value = item.second;
+							continue;
+						}
+
+						Node* node = builder.node_pool.New(hashes[i], item.first, item.second);
+						try {
+							LinkNode(builder, slot, node);
+						}
+						catch (...) {
+							builder.node_pool.Delete(node);
+							throw;
+						}
+					}
+				}
+			}
+			catch (...) {
+				builder.error = std::current_exception();
+			}
+
+			if constexpr (!Chaining::INTRUSIVE) {
+				size_t end = (owner + 1) * buckets_per_thread;
+				if (end > _array->Capacity()) {
+					end = _array->Capacity();
+				}
+
+				for (size_t i = owner * buckets_per_thread; i < end; i++) {
+					if (Slot slot = (*_array)[i]) {
+						slot->SetPool(&_list_node_pool);
+					}
+				}
+			}
+		}
+
+		template <typename Function>
+		static void RunParallel(size_t threads, Function fn) {
+			std::vector<std::thread> workers;
+			size_t started = 1;
+
+			try {
+				workers.reserve(threads);
+				for (; started < threads; started++) {
+					workers.emplace_back(fn, started);
+				}
+			}
+			catch (...) {
+				// Parts without a thread run here, so every part is always processed.
+			}
+
+			fn(0);
+			for (size_t t = started; t < threads; t++) {
+				fn(t);
+			}
+
+			for (std::thread& worker : workers) {
+				worker.join();
+			}
+		}
+
+		void Repack(size_t capacity) {
+			if (_old_array) {
+				MigrateBuckets(_old_array->Capacity());
+			}
+
+			Timer timer(_stats);
+
+			DA::DynArr<Slot>* new_array;
+
+			try {
+				new_array = new DA::DynArr<Slot>(capacity, nullptr);
+			}
+			catch (const std::bad_alloc& ex) {
+				throw std::runtime_error("HT::Repack() -> " + std::string(ex.what()));
+			}
+
+			Builder builder;
+
+			// Entries are moved when that cannot throw, and each source is remembered so a failed
+			// allocation can move it back; otherwise they are copied and the sources stay untouched.
+			constexpr bool MOVE = std::is_nothrow_move_constructible_v<K> && std::is_nothrow_move_constructible_v<T>;
+			std::vector<std::pair<Node*, Node*>> moved;
+
+			try {
+				if constexpr (MOVE) {
+					moved.reserve(_elements);
+				}
+
+				for (Slot slot : *_array) {
+					BucketForEach(slot, [&builder, &moved, new_array, capacity](Node* node) {
+						Node* fresh;
+						if constexpr (MOVE) {
+							fresh = builder.node_pool.New(node->hash, std::move(node->key), std::move(node->value));
+							moved.emplace_back(node, fresh);
+						}
+						else {
+							fresh = builder.node_pool.New(node->hash, node->key, node->value);
+						}
+
+						try {
+							LinkNode(builder, (*new_array)[GetHashIndex(node->hash, capacity)], fresh);
+						}
+						catch (...) {
+							if constexpr (!MOVE) {
+								builder.node_pool.Delete(fresh);
+							}
+							throw;
+						}
+					});
+				}
+			}
+			catch (const std::exception& ex) {
+				if constexpr (MOVE) {
+					for (auto& [node, fresh] : moved) {
+						node->key.~K();
+						new (&node->key) K(std::move(fresh->key));
+						node->value.~T();
+						new (&node->value) T(std::move(fresh->value));
+						fresh->~Node();
+					}
+				}
+				else if constexpr (!std::is_trivially_destructible_v<Node>) {
+					for (Slot slot : *new_array) {
+						BucketForEach(slot, [](Node* node) { node->~Node(); });
+					}
+				}
+				delete new_array;
+				throw std::runtime_error("HT::Repack() -> " + std::string(ex.what()));
+			}
+
+			Clear();
+			delete _array;
+			_array = new_array;
+
+			_node_pool.Splice(builder.node_pool);
+			_list_pool.Splice(builder.list_pool);
+			_list_node_pool.Splice(builder.list_node_pool);
+
+			if constexpr (!Chaining::INTRUSIVE) {
+				for (Slot slot : *_array) {
+					if (slot) {
+						slot->SetPool(&_list_node_pool);
+					}
+				}
+			}
+
+			_lists = builder.lists;
+			_elements = builder.elements;
+
+			_stats.OnReHash();
+			_stats.OnAllocate(builder.elements + builder.lists + 1);
+			CountChains();
+			RebuildFilter();
+		}
+
+		void ShrinkIfSparse() {
+			if (_old_array || _array->Capacity() <= _min_capacity || _elements >= _array->Capacity() * SHRINK_FACTOR) {
+				return;
+			}
+
+			// Both paths relink the existing nodes, so the surviving entries keep their addresses.
+			if (_rehash_step) {
+				StartReHash(_array->Capacity() / _array->Factor());
+			}
+			else {
+				ReHash(_array->Capacity() / _array->Factor());
 			}
-			index = index % _array->Capacity();
-
-			return index;
 		}
 
-		void ExpandAndReHash() {
-			DA::DynArr<DLL::DoubLinList<Node*>*>* new_array;
-
-			try {
-				new_array = new DA::DynArr<DLL::DoubLinList<Node*>*>(_array->Factor() * _array->Capacity());
+		void Clear() {
+			for (Slot& slot : *_array) {
+				if (slot) {
+					if constexpr (!std::is_trivially_destructible_v<Node>) {
+						BucketForEach(slot, [](Node* node) { node->~Node(); });
+					}
+					slot = nullptr;
+				}
 			}
-			catch (const std::bad_alloc& ex) {
-				throw std::runtime_error("HT::ExpandAndReHash() -> " + std::string(ex.what()));
+
+			if (_old_array) {
+				if constexpr (!std::is_trivially_destructible_v<Node>) {
+					for (Slot slot : *_old_array) {
+						BucketForEach(slot, [](Node* node) { node->~Node(); });
+					}
+				}
+				delete _old_array;
+				_old_array = nullptr;
 			}
 
-			DA::DynArr<DLL::DoubLinList<Node*>*>* old_array = _array;
-			size_t old_lists = _lists;
+			_node_pool.Release();
+			_list_pool.Release();
+			_list_node_pool.Release();
 
-			_array = new_array;
+			_elements = 0;
 			_lists = 0;
+			_stats.OnChainsReset();
+		}
 
+		template <typename Q>
+		void PopKey(const Q& key) {
 			try {
-				for (int i = 0; i < old_array->Capacity(); i++) {
-					if ((*old_array)[i]) {
-						for (int j = 0; j < (*old_array)[i]->Size(); j++) {
-							Node* temp = (*(*old_array)[i])[j];
-							PasteNode(temp);
-						}
-						delete (*old_array)[i];
-					}
+				if (_old_array) {
+					MigrateBuckets(_rehash_step ? _rehash_step : _old_array->Capacity());
 				}
-			}
-			catch (const std::bad_alloc& ex) {
-				throw std::runtime_error("HT::ExpandAndReHash() -> " + std::string(ex.what()));
-			}
-			
-			delete old_array;
-		}
 
-		void PasteNode(Node* node) {
-			size_t index = GetHashIndex(node->key);
-
-			if (!(*_array)[index]) {
-				(*_array)[index] = new DLL::DoubLinList<Node*>();
-				_lists++;
-			}
+				uint64_t hash = GetHash(key);
+				if (!_filter.MayContain(hash)) {
+					return;
+				}
 
-			try {
-				(*_array)[index]->Push(node);
+				if (PopFromArray(_array, hash, key) || (_old_array && PopFromArray(_old_array, hash, key))) {
+					_elements--;
+					_filter.Remove(hash);
+					ShrinkIfSparse();
+				}
 			}
 			catch (const std::exception& ex) {
-				throw std::runtime_error("HT::PasteNode() -> " + std::string(ex.what()));
+				throw std::runtime_error("HT::Pop() -> " + std::string(ex.what()));
 			}
 		}
 
-		double CalculateArrayLoad() const {
-			if (_lists) {
-				return 100 / (double(_array->Capacity()) / double(_lists));
+	public:
+		using Key = K;
+
+		struct Node : NodeLink<Node, Chaining::INTRUSIVE, Chaining::INTRUSIVE && Stats::ENABLED> {
+			uint64_t hash;
+			K key;
+			T value;
+
+			template <typename KArg, typename... Args>
+			Node(uint64_t in_hash, KArg&& in_key, Args&&... args) : hash(in_hash), key(std::forward<KArg>(in_key)), value(std::forward<Args>(args)...) {}
+		};
+
+		template <bool CONST>
+		class BasicIterator {
+			using Position = std::conditional_t<Chaining::INTRUSIVE, Node*, typename List::ConstIterator>;
+
+			const HashMap* map;
+			const DA::DynArr<Slot>* array;
+			size_t bucket;
+			Position position;
+
+			bool Valid() const {
+				return position != Position();
 			}
-			return 0;
-		}
 
-		double CalculateListElementMinCount() const {
-			double min = 0.0;
+			void Enter() {
+				Slot slot = (*array)[bucket];
+				if constexpr (Chaining::INTRUSIVE) {
+					position = slot;
+				}
+				else {
+					position = slot ? slot->begin() : Position();
+				}
+			}
 
-			for (int i = 0; i < _array->Capacity(); i++) {
-				if ((*_array)[i]) {
-					if (!min) {
-						min = double((*_array)[i]->Size());
+			void Settle() {
+				while (array && !Valid()) {
+					if (++bucket < array->Capacity()) {
+						Enter();
+						continue;
 					}
-					if ((*_array)[i]->Size() < min) {
-						min = double((*_array)[i]->Size());
+
+					array = array == map->_array ? map->_old_array : nullptr;
+					bucket = 0;
+					if (array) {
+						Enter();
 					}
 				}
 			}
 
-			return min;
-		}
+			template <bool>
+			friend class BasicIterator;
 
-		double CalculateListElementMaxCount() const {
-			int max = 0.0;
+			friend class HashMap;
 
-			for (int i = 0; i < _array->Capacity(); i++) {
-				if ((*_array)[i] && (*_array)[i]->Size() > max) {
-					max = double((*_array)[i]->Size());
+			BasicIterator(const HashMap* in_map, const DA::DynArr<Slot>* in_array) : map(in_map), array(in_array), bucket(0), position() {
+				if (array) {
+					Enter();
+					Settle();
 				}
 			}
 
-			return max;
-		}
+		public:
+			using iterator_category = std::forward_iterator_tag;
+			using value_type = Node;
+			using difference_type = std::ptrdiff_t;
+			using pointer = std::conditional_t<CONST, const Node*, Node*>;
+			using reference = std::conditional_t<CONST, const Node&, Node&>;
 
-		double CalculateListElementAvgCount() const {
-			if (_lists) {
-				return double(_elements) / double(_lists);
+			BasicIterator() : map(nullptr), array(nullptr), bucket(0), position() {}
+
+			template <bool OTHER, std::enable_if_t<CONST && !OTHER, int> = 0>
+			BasicIterator(const BasicIterator<OTHER>& other) : map(other.map), array(other.array), bucket(other.bucket), position(other.position) {}
+
+			reference operator*() const {
+				if constexpr (Chaining::INTRUSIVE) {
+					return *position;
+				}
+				else {
+					return **position;
+				}
 			}
-			return 0;
-		}
 
-	public:
-		struct Node {
-			std::string key;
-			T value;
+			pointer operator->() const {
+				return &**this;
+			}
+
+			BasicIterator& operator++() {
+				if constexpr (Chaining::INTRUSIVE) {
+					position = position->next;
+				}
+				else {
+					++position;
+				}
+				Settle();
+				return *this;
+			}
+
+			BasicIterator operator++(int) {
+				BasicIterator temp = *this;
+				++*this;
+				return temp;
+			}
+
+			bool operator==(const BasicIterator& other) const {
+				return array == other.array && bucket == other.bucket && position == other.position;
+			}
 
-			Node(std::string in_key) : key(in_key) {}
-			Node(std::string in_key, T in_value) : key(in_key), value(in_value) {}
+			bool operator!=(const BasicIterator& other) const {
+				return !(*this == other);
+			}
 		};
 
-		HashTable() : _lists(0), _elements(0) {
+		using Iterator = BasicIterator<false>;
+		using ConstIterator = BasicIterator<true>;
+
+		HashMap(size_t expected = 0) : _old_array(nullptr), _migrated(0), _rehash_step(0), _min_capacity(CapacityFor(expected)), _lists(0), _elements(0) {
 			try {
-				_array = new DA::DynArr<DLL::DoubLinList<Node*>*>(1024);
+				_array = new DA::DynArr<Slot>(_min_capacity, nullptr);
 			}
 			catch (const std::bad_alloc& ex) {
-				throw std::runtime_error("HT::HashTable() -> " + std::string(ex.what()));
+				throw std::runtime_error("HT::HashMap() -> " + std::string(ex.what()));
+			}
+
+			RebuildFilter();
+		}
+
+		template <typename Iterator>
+		HashMap(Iterator first, Iterator last, unsigned int threads = 0) : HashMap(size_t(last - first)) {
+			try {
+				BulkBuild(first, last, threads);
+			}
+			catch (const std::exception& ex) {
+				throw std::runtime_error("HT::HashMap() -> " + std::string(ex.what()));
 			}
 		}
 
-		~HashTable() {
-			Erase();
+		~HashMap() {
+			Clear();
 			delete _array;
 		}
 
+		size_t ReHashStep() const {
+			return _rehash_step;
+		}
+
+		void SetReHashStep(size_t step) {
+			_rehash_step = step;
+		}
+
+		bool IsReHashing() const {
+			return _old_array != nullptr;
+		}
+
 		size_t Lists() const {
 			return _lists;
 		}
@@ -156,105 +1363,354 @@ namespace HT {
 			return _array->Capacity();
 		}
 
-		size_t ListSize(size_t index) const {
-			if ((*_array)[index]) {
-				return (*_array)[index]->Size();
+		Iterator begin() {
+			return Iterator(this, _array);
+		}
+
+		Iterator end() {
+			return Iterator();
+		}
+
+		ConstIterator begin() const {
+			return ConstIterator(this, _array);
+		}
+
+		ConstIterator end() const {
+			return ConstIterator();
+		}
+
+		template <typename Function>
+		void ForEach(Function fn) {
+			for (const DA::DynArr<Slot>* array : { _array, _old_array }) {
+				if (array) {
+					for (Slot slot : *array) {
+						BucketForEach(slot, [&fn](Node* node) { fn(*node); });
+					}
+				}
 			}
-			return 0;
 		}
 
-		void Push(std::string key, T value) {
-			Node* node = new Node(key, value);
-			size_t index = GetHashIndex(key);
-			
-			if (!(*_array)[index]) {
-				(*_array)[index] = new DLL::DoubLinList<Node*>();
-				_lists++;
+		template <typename Function>
+		void ForEach(Function fn) const {
+			for (const DA::DynArr<Slot>* array : { _array, _old_array }) {
+				if (array) {
+					for (Slot slot : *array) {
+						BucketForEach(slot, [&fn](const Node* node) { fn(*node); });
+					}
+				}
 			}
+		}
 
+		void Reserve(size_t elements) {
 			try {
-				if (Node* existing_node = Find(node->key)) {
-					existing_node->value = value;
+				if (_old_array) {
+					MigrateBuckets(_old_array->Capacity());
 				}
-				else {
-					(*_array)[index]->Push(node);
-					_elements++;
+
+				size_t capacity = CapacityFor(elements);
+				if (capacity > _array->Capacity()) {
+					ReHash(capacity);
+				}
+				if (capacity > _min_capacity) {
+					_min_capacity = capacity;
 				}
 			}
-			catch (const std::bad_alloc& ex) {
-				throw std::runtime_error("HT::Push() -> " + std::string(ex.what()));
+			catch (const std::exception& ex) {
+				throw std::runtime_error("HT::Reserve() -> " + std::string(ex.what()));
 			}
-			
-			if (_elements > (*_array).Capacity() * FACTOR) {
-				try {
-					ExpandAndReHash();
+		}
+
+		template <typename Iterator>
+		void BulkBuild(Iterator first, Iterator last, unsigned int threads = 0) {
+			size_t count = size_t(last - first);
+
+			try {
+				Reserve(_elements + count);
+
+				if (_elements) {
+					for (Iterator it = first; it != last; ++it) {
+						Push(it->first, it->second);
+					}
+					return;
 				}
-				catch (const std::exception& ex) {
-					throw std::runtime_error("HT::Push() -> " + std::string(ex.what()));
+
+				if (!threads) {
+					threads = std::thread::hardware_concurrency();
 				}
+				if (!threads) {
+					threads = 1;
+				}
+
+				size_t capacity = _array->Capacity();
+				size_t buckets_per_thread = (capacity + threads - 1) / threads;
+				size_t per_thread = (count + threads - 1) / threads;
+
+				std::vector<uint64_t> hashes(count);
+				std::vector<Builder> builders(threads);
+				for (Builder& builder : builders) {
+					builder.parts.resize(threads);
+				}
+
+				RunParallel(threads, [&](size_t t) {
+					size_t begin = t * per_thread < count ? t * per_thread : count;
+					size_t end = begin + per_thread < count ? begin + per_thread : count;
+
+					HashPart(first, hashes, begin, end, buckets_per_thread, builders[t]);
+				});
+
+				for (Builder& builder : builders) {
+					if (builder.error) {
+						std::rethrow_exception(builder.error);
+					}
+				}
+
+				RunParallel(threads, [&](size_t t) {
+					LinkPart(first, hashes, builders, t, buckets_per_thread);
+				});
+
+				std::exception_ptr error;
+				for (Builder& builder : builders) {
+					_node_pool.Splice(builder.node_pool);
+					_list_pool.Splice(builder.list_pool);
+					_list_node_pool.Splice(builder.list_node_pool);
+					_lists += builder.lists;
+					_elements += builder.elements;
+					_stats.OnAllocate(builder.elements + builder.lists);
+
+					if (builder.error && !error) {
+						error = builder.error;
+					}
+				}
+
+				CountChains();
+				RebuildFilter();
+
+				if (error) {
+					std::rethrow_exception(error);
+				}
+			}
+			catch (const std::exception& ex) {
+				throw std::runtime_error("HT::BulkBuild() -> " + std::string(ex.what()));
 			}
 		}
 
-		Node* Find(std::string key) const {
-			size_t index = GetHashIndex(key);
+		const Stats& Statistics() const {
+			return _stats;
+		}
+
+		size_t ListSize(size_t index) const {
+			return BucketSize((*_array)[index]);
+		}
 
-			if (!(*_array)[index]) {
-				return nullptr;
+		template <typename M>
+		void Push(const K& key, M&& value) {
+			try {
+				InsertOrAssignHashed(GetHash(key), key, std::forward<M>(value));
+			}
+			catch (const std::exception& ex) {
+				throw std::runtime_error("HT::Push() -> " + std::string(ex.what()));
 			}
+		}
 
-			Node* temp = new Node(key);
+		template <typename M>
+		void Push(K&& key, M&& value) {
+			try {
+				uint64_t hash = GetHash(key);
+				InsertOrAssignHashed(hash, std::move(key), std::forward<M>(value));
+			}
+			catch (const std::exception& ex) {
+				throw std::runtime_error("HT::Push() -> " + std::string(ex.what()));
+			}
+		}
 
+		// Inserts T(args...) or replaces the existing value with it.
+		template <typename... Args>
+		std::pair<Node*, bool> Emplace(const K& key, Args&&... args) {
 			try {
-				if (auto found = (*_array)[index]->Find(temp, [](Node* a, Node* b) -> bool { return a->key == b->key; })) {
-					return found->data;
+				auto result = TryEmplaceHashed(GetHash(key), key, std::forward<Args>(args)...);
+				if (!result.second) {
+					result.first->value = T(std::forward<Args>(args)...);
 				}
+				return result;
 			}
 			catch (const std::exception& ex) {
-				delete temp;
-				throw std::runtime_error("HT::Find() -> " + std::string(ex.what()));
+				throw std::runtime_error("HT::Emplace() -> " + std::string(ex.what()));
 			}
+		}
 
-			delete temp;
-			return nullptr;
+		template <typename... Args>
+		std::pair<Node*, bool> Emplace(K&& key, Args&&... args) {
+			try {
+				uint64_t hash = GetHash(key);
+				auto result = TryEmplaceHashed(hash, std::move(key), std::forward<Args>(args)...);
+				if (!result.second) {
+					result.first->value = T(std::forward<Args>(args)...);
+				}
+				return result;
+			}
+			catch (const std::exception& ex) {
+				throw std::runtime_error("HT::Emplace() -> " + std::string(ex.what()));
+			}
 		}
 
-		void Pop(std::string key) {
-			size_t index = GetHashIndex(key);
+		// Inserts T(args...) only when the key is missing; an existing value is left as is.
+		template <typename... Args>
+		std::pair<Node*, bool> TryEmplace(const K& key, Args&&... args) {
+			try {
+				return TryEmplaceHashed(GetHash(key), key, std::forward<Args>(args)...);
+			}
+			catch (const std::exception& ex) {
+				throw std::runtime_error("HT::TryEmplace() -> " + std::string(ex.what()));
+			}
+		}
 
-			if (!(*_array)[index]) {
-				return;
+		template <typename... Args>
+		std::pair<Node*, bool> TryEmplace(K&& key, Args&&... args) {
+			try {
+				uint64_t hash = GetHash(key);
+				return TryEmplaceHashed(hash, std::move(key), std::forward<Args>(args)...);
+			}
+			catch (const std::exception& ex) {
+				throw std::runtime_error("HT::TryEmplace() -> " + std::string(ex.what()));
 			}
+		}
 
-			Node* temp = new Node(key);
+		template <typename M>
+		std::pair<Node*, bool> InsertOrAssign(const K& key, M&& value) {
+			try {
+				return InsertOrAssignHashed(GetHash(key), key, std::forward<M>(value));
+			}
+			catch (const std::exception& ex) {
+				throw std::runtime_error("HT::InsertOrAssign() -> " + std::string(ex.what()));
+			}
+		}
 
+		template <typename M>
+		std::pair<Node*, bool> InsertOrAssign(K&& key, M&& value) {
 			try {
-				(*_array)[index]->Remove(temp, [](Node* a, Node* b) -> bool { return a->key == b->key; });
+				uint64_t hash = GetHash(key);
+				return InsertOrAssignHashed(hash, std::move(key), std::forward<M>(value));
 			}
 			catch (const std::exception& ex) {
-				delete temp;
-				throw std::runtime_error("HT::Pop() -> " + std::string(ex.what()));
+				throw std::runtime_error("HT::InsertOrAssign() -> " + std::string(ex.what()));
 			}
+		}
 
-			if ((*_array)[index]->Size() == 0) {
-				delete (*_array)[index];
-				(*_array)[index] = nullptr;
-				_lists--;
+		void PushBatch(const K* keys, const T* values, size_t count) {
+			uint64_t hashes[BATCH];
+
+			try {
+				for (size_t start = 0; start < count; start += BATCH) {
+					size_t n = count - start < BATCH ? count - start : BATCH;
+
+					for (size_t i = 0; i < n; i++) {
+						hashes[i] = GetHash(keys[start + i]);
+						Prefetch(&(*_array)[GetHashIndex(hashes[i], _array->Capacity())]);
+					}
+
+					for (size_t i = 0; i < n; i++) {
+						InsertOrAssignHashed(hashes[i], keys[start + i], values[start + i]);
+					}
+				}
+			}
+			catch (const std::exception& ex) {
+				throw std::runtime_error("HT::PushBatch() -> " + std::string(ex.what()));
 			}
+		}
 
-			_elements--;
-			delete temp;
+		Node* Find(const K& key) const {
+			return FindKey(key);
 		}
 
-		void Erase() {
-			for (int i = 0; i < _array->Capacity(); i++) {
-				if ((*_array)[i]) {
-					delete (*_array)[i];
-					(*_array)[i] = nullptr;
+		template <typename Q, EnableIfTransparent<Q> = 0>
+		Node* Find(const Q& key) const {
+			return FindKey(key);
+		}
+
+		void FindBatch(const K* keys, size_t count, Node** out) const {
+			FindBatchKeys(keys, count, out);
+		}
+
+		template <typename Q, EnableIfTransparent<Q> = 0>
+		void FindBatch(const Q* keys, size_t count, Node** out) const {
+			FindBatchKeys(keys, count, out);
+		}
+
+		bool Contains(const K& key) const {
+			return FindKey(key) != nullptr;
+		}
+
+		template <typename Q, EnableIfTransparent<Q> = 0>
+		bool Contains(const Q& key) const {
+			return FindKey(key) != nullptr;
+		}
+
+		// Only pointers to the popped entry are invalidated; an automatic shrink relinks the others in place.
+		void Pop(const K& key) {
+			PopKey(key);
+		}
+
+		template <typename Q, EnableIfTransparent<Q> = 0>
+		void Pop(const Q& key) {
+			PopKey(key);
+		}
+
+		void ShrinkToFit() {
+			try {
+				if (_old_array) {
+					MigrateBuckets(_old_array->Capacity());
+				}
+
+				size_t capacity = std::max(CapacityFor(_elements), _min_capacity);
+				if (capacity < _array->Capacity()) {
+					ReHash(capacity);
 				}
 			}
+			catch (const std::exception& ex) {
+				throw std::runtime_error("HT::ShrinkToFit() -> " + std::string(ex.what()));
+			}
+		}
 
-			_elements = 0;
-			_lists = 0;
+		// Moves every entry into fresh pools, so all Node pointers and iterators are invalidated.
+		void Compact() {
+			try {
+				size_t capacity = std::max(CapacityFor(_elements), _min_capacity);
+				Repack(capacity < _array->Capacity() ? capacity : _array->Capacity());
+			}
+			catch (const std::exception& ex) {
+				throw std::runtime_error("HT::Compact() -> " + std::string(ex.what()));
+			}
+		}
+
+		// Copies the elements into an immutable table indexed by a minimal perfect hash.
+		PHT::PerfectHashMap<K, T, Hash, KeyEqual> Freeze() const {
+			try {
+				std::vector<typename PHT::PerfectHashMap<K, T, Hash, KeyEqual>::Item> items;
+				items.reserve(_elements);
+				ForEach([&items](const Node& node) { items.push_back({ node.hash, &node.key, &node.value }); });
+
+				return PHT::PerfectHashMap<K, T, Hash, KeyEqual>(items);
+			}
+			catch (const std::exception& ex) {
+				throw std::runtime_error("HT::Freeze() -> " + std::string(ex.what()));
+			}
+		}
+
+		void Erase() {
+			Clear();
+
+			if (_array->Capacity() > _min_capacity) {
+				try {
+					DA::DynArr<Slot>* new_array = new DA::DynArr<Slot>(_min_capacity, nullptr);
+					_stats.OnAllocate();
+					delete _array;
+					_array = new_array;
+				}
+				catch (const std::bad_alloc& ex) {
+					throw std::runtime_error("HT::Erase() -> " + std::string(ex.what()));
+				}
+			}
+			RebuildFilter();
 		}
 
 		std::string ToString(unsigned int limit = 0, std::string(*out_to_string)(T) = nullptr) const {
@@ -267,43 +1723,42 @@ namespace HT {
 			text += "> all lists: " + std::to_string(int(_array->Capacity())) + "\n";
 			text += "> non null lists: " + std::to_string(int(_lists)) + "\n";
 			text += "> array load: " + std::to_string(CalculateArrayLoad()) + "%\n";
-			text += "> min: " + std::to_string(CalculateListElementMinCount()) + "\n";
-			text += "> avg: " + std::to_string(CalculateListElementAvgCount()) + "\n";
-			text += "> max: " + std::to_string(CalculateListElementMaxCount()) + "\n";
+			if constexpr (Stats::ENABLED) {
+				text += "> min: " + std::to_string(double(_stats.ShortestChain())) + "\n";
+				text += "> avg: " + std::to_string(CalculateListElementAvgCount()) + "\n";
+				text += "> max: " + std::to_string(double(_stats.LongestChain())) + "\n";
+				text += _stats.ToString();
+			}
+			else {
+				text += "> min: " + std::to_string(CalculateListElementMinCount()) + "\n";
+				text += "> avg: " + std::to_string(CalculateListElementAvgCount()) + "\n";
+				text += "> max: " + std::to_string(CalculateListElementMaxCount()) + "\n";
+			}
 			text += "{\n";
 
-			if (out_to_string) {
-				int shown = 0;
-				for (int i = 0; i < _array->Capacity(); i++) {
-					if ((*_array)[i]) {
-						text += std::to_string(i) + ": ";
-						for (int j = 0; j < (*_array)[i]->Size(); j++) {
-							text += (*(*_array)[i])[j]->key + " -> " + out_to_string((*(*_array)[i])[j]->value);
-							text += "; ";
-						}
-						text += "\n";
-						shown++;
-					}
-					if (shown >= limit) {
-						break;
-					}
-				}
-			}
-			else if constexpr (std::is_arithmetic_v<T>) {
-				int shown = 0;
-				for (int i = 0; i < _array->Capacity(); i++) {
-					if ((*_array)[i]) {
+			if (out_to_string || std::is_arithmetic_v<T>) {
+				size_t shown = 0;
+				size_t i = 0;
+				for (Slot slot : *_array) {
+					if (slot) {
 						text += std::to_string(i) + ": ";
-						for (int j = 0; j < (*_array)[i]->Size(); j++) {
-							text += (*(*_array)[i])[j]->key + " -> " + std::to_string((*(*_array)[i])[j]->value);
+						BucketForEach(slot, [&text, out_to_string](Node* node) {
+							text += KeyToString(node->key) + " -> ";
+							if (out_to_string) {
+								text += out_to_string(node->value);
+							}
+							else if constexpr (std::is_arithmetic_v<T>) {
+								text += std::to_string(node->value);
+							}
 							text += "; ";
-						}
+						});
 						text += "\n";
 						shown++;
 					}
 					if (shown >= limit) {
 						break;
 					}
+					i++;
 				}
 			}
 			else {
@@ -319,4 +1774,7 @@ namespace HT {
 			return text;
 		}
 	};
+
+	template <typename T, typename Hash = HF::Hash<std::string>, typename Chaining = ListChaining, typename Stats = NoStats, typename Filter = NoFilter>
+	using HashTable = HashMap<std::string, T, Hash, HF::Equal<std::string>, Chaining, Stats, Filter>;
 }
\ No newline at end of file
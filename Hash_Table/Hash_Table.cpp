@@ -1,9 +1,69 @@
 #include <iostream>
 #include <random>
 #include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <new>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <algorithm>
+#if defined(_WIN32)
+#define NOMINMAX
+#include <windows.h>
+#elif defined(__GLIBC__)
+#include <malloc.h>
+#endif
 #include "HT.h"
+#include "FHT.h"
+#include "SHT.h"
+#include "LFHT.h"
+#include "SNAP.h"
+#include "LRU.h"
+#include "TTL.h"
 
-std::string GenerateWord(std::random_device& rd, std::default_random_engine& dre, size_t size) {
+static std::atomic<size_t> allocations(0);
+static bool find_allocated = false;
+
+// The replacement allocator stays out of line like the library one; once inlined, the compiler pairs
+// its malloc and free with new and delete expressions and reports them as mismatched.
+#if defined(_MSC_VER)
+#define ALLOCATOR_NOINLINE __declspec(noinline)
+#else
+#define ALLOCATOR_NOINLINE __attribute__((noinline))
+#endif
+
+ALLOCATOR_NOINLINE void* operator new(size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* ptr = std::malloc(size ? size : 1)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+ALLOCATOR_NOINLINE void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+ALLOCATOR_NOINLINE void operator delete(void* ptr, size_t) noexcept {
+    std::free(ptr);
+}
+
+// Bytes currently allocated from the C runtime heap, which also backs operator new.
+size_t HeapInUse() {
+#if defined(_WIN32)
+    HEAP_SUMMARY summary = {};
+    summary.cb = sizeof(summary);
+    return HeapSummary(GetProcessHeap(), 0, &summary) ? size_t(summary.cbAllocated) : 0;
+#elif defined(__GLIBC__) && (__GLIBC__ > 2 || __GLIBC_MINOR__ >= 33)
+    struct mallinfo2 info = mallinfo2();
+    return info.uordblks + info.hblkhd;
+#else
+    return 0;
+#endif
+}
+
+std::string GenerateWord(std::default_random_engine& dre, size_t size) {
     const int LETTES_SIZE = 26;
     const char LETTERS[LETTES_SIZE] = { 'A', 'B', 'C', 'D', 'E', 'F', 'G', 'H', 'I', 'J', 'K', 'L', 'M', 'N', 'O', 'P', 'Q', 'R', 'S', 'T', 'U', 'V', 'W', 'X', 'Y', 'Z' };
 
@@ -11,54 +71,80 @@ std::string GenerateWord(std::random_device& rd, std::default_random_engine& dre
 
     std::string word = "";
 
-    for (int i = 0; i < size; i++) {
+    for (size_t i = 0; i < size; i++) {
         word += LETTERS[rnd_let(dre)];
     }
 
     return word;
 }
 
-int main() {
+template <typename K>
+K GenerateKey(std::default_random_engine& dre, size_t size) {
+    if constexpr (std::is_same_v<K, std::string>) {
+        return GenerateWord(dre, size);
+    }
+    else {
+        std::uniform_int_distribution<uint64_t> rnd_key(0, uint64_t(pow(26, size)) - 1);
+        return K(rnd_key(dre));
+    }
+}
+
+template <typename Table>
+void Benchmark(const std::string& name, std::default_random_engine& dre) {
     const int WORD_COUNT = 6;
     const int MAX_ORDER = 6;
 
-    static std::random_device rd;
-    static std::default_random_engine dre(rd());
     std::uniform_int_distribution<int> rnd_num(0, MAX_ORDER * 1000);
 
-    HT::HashTable<int>* ht = new HT::HashTable<int>();
+    Table* ht = new Table();
 
     for (int i = 1; i <= MAX_ORDER; i++) {
         std::cout << "--------------------------------" << std::endl;
-        std::cout << "Test: " << i << std::endl << std::endl;
+        std::cout << name << " test: " << i << std::endl << std::endl;
 
         int n = pow(10, i);
 
+        typename Table::Key* push_keys = new typename Table::Key[n];
+        int* push_values = new int[n];
+        for (int j = 0; j < n; j++) {
+            push_keys[j] = GenerateKey<typename Table::Key>(dre, WORD_COUNT);
+            push_values[j] = rnd_num(dre);
+        }
+
+        size_t allocations_before = allocations;
         std::chrono::high_resolution_clock::time_point start_time = std::chrono::high_resolution_clock::now();
-        for (int j = 1; j <= n; j++) {
-            std::string key = GenerateWord(rd, dre, WORD_COUNT);
-            int value = rnd_num(dre);
+        for (int j = 0; j < n; j++) {
             try {
-                ht->Push(key, value);
+                ht->Push(push_keys[j], push_values[j]);
             }
             catch (const std::exception& ex) {
                 std::cerr << "Eror in push " << j << " -> " << ex.what() << std::endl;
             }
         }
         std::chrono::high_resolution_clock::time_point end_time = std::chrono::high_resolution_clock::now();
+        size_t push_allocations = allocations - allocations_before;
+
+        delete[] push_keys;
+        delete[] push_values;
 
         std::chrono::duration<double> pushing_time = end_time - start_time;
-        std::cout << "Pushing time: " << pushing_time.count() << "s" << std::endl << std::endl;
+        std::cout << "Pushing time: " << pushing_time.count() << "s" << std::endl;
+        std::cout << "Push allocations: " << push_allocations << std::endl << std::endl;
         std::cout << ht->ToString(8) << std::endl;
 
         int hits = 0;
         const int m = pow(10, 4);
 
+        typename Table::Key* keys = new typename Table::Key[m];
+        for (int j = 0; j < m; j++) {
+            keys[j] = GenerateKey<typename Table::Key>(dre, WORD_COUNT);
+        }
+
+        allocations_before = allocations;
         start_time = std::chrono::high_resolution_clock::now();
-        for (int j = 1; j <= m; j++) {
+        for (int j = 0; j < m; j++) {
             try {
-                std::string key = GenerateWord(rd, dre, WORD_COUNT);
-                if (ht->Find(key)) {
+                if (ht->Find(keys[j])) {
                     hits++;
                 }
             }
@@ -67,10 +153,18 @@ int main() {
             }
         }
         end_time = std::chrono::high_resolution_clock::now();
+        size_t find_allocations = allocations - allocations_before;
+
+        delete[] keys;
 
         std::chrono::duration<double> finding_time = end_time - start_time;
         std::cout << "Finding time: " << finding_time.count() << "s" << std::endl;
-        std::cout << "Hits: " << hits << std::endl << std::endl;
+        std::cout << "Hits: " << hits << std::endl;
+        std::cout << "Find allocations: " << find_allocations << std::endl << std::endl;
+        if (find_allocations) {
+            std::cerr << "Find allocated memory " << find_allocations << " times" << std::endl;
+            find_allocated = true;
+        }
 
         double total_time = pushing_time.count() + finding_time.count();
         std::cout << "Total time: " << total_time << "s" << std::endl;
@@ -79,5 +173,636 @@ int main() {
     }
 
     delete ht;
-    return 0;
+}
+
+template <typename Table>
+void BenchmarkThreads(const std::string& name, std::default_random_engine& dre) {
+    const int WORD_COUNT = 6;
+    const int KEY_COUNT = 1000000;
+    const int OPS_PER_THREAD = 1000000;
+    const int FIND_PERCENT = 90;
+
+    std::uniform_int_distribution<int> rnd_num(0, KEY_COUNT);
+
+    std::vector<typename Table::Key> keys(KEY_COUNT);
+    for (int j = 0; j < KEY_COUNT; j++) {
+        keys[j] = GenerateKey<typename Table::Key>(dre, WORD_COUNT);
+    }
+
+    Table* ht = new Table();
+    for (int j = 0; j < KEY_COUNT; j += 2) {
+        ht->Push(keys[j], rnd_num(dre));
+    }
+
+    unsigned int max_threads = std::thread::hardware_concurrency();
+    if (!max_threads) {
+        max_threads = 1;
+    }
+
+    std::cout << "--------------------------------" << std::endl;
+    std::cout << name << " threads test (" << FIND_PERCENT << "% find)" << std::endl << std::endl;
+
+    for (unsigned int threads = 1;; threads *= 2) {
+        if (threads > max_threads) {
+            threads = max_threads;
+        }
+
+        std::vector<std::thread> workers;
+        std::chrono::high_resolution_clock::time_point start_time = std::chrono::high_resolution_clock::now();
+        for (unsigned int t = 0; t < threads; t++) {
+            workers.emplace_back([ht, &keys, t]() {
+                std::default_random_engine engine(t + 1);
+                std::uniform_int_distribution<int> rnd_key(0, KEY_COUNT - 1);
+                std::uniform_int_distribution<int> rnd_op(0, 99);
+                int hits = 0;
+
+                for (int j = 0; j < OPS_PER_THREAD; j++) {
+                    const typename Table::Key& key = keys[rnd_key(engine)];
+                    if (rnd_op(engine) < FIND_PERCENT) {
+                        hits += ht->Contains(key);
+                    }
+                    else {
+                        ht->Push(key, j);
+                    }
+                }
+
+                if (hits < 0) {
+                    std::cerr << "Unreachable" << std::endl;
+                }
+            });
+        }
+        for (std::thread& worker : workers) {
+            worker.join();
+        }
+        std::chrono::high_resolution_clock::time_point end_time = std::chrono::high_resolution_clock::now();
+
+        std::chrono::duration<double> time = end_time - start_time;
+        double ops = double(threads) * OPS_PER_THREAD / time.count();
+        std::cout << "Threads: " << threads << ", time: " << time.count() << "s, " << ops / 1e6 << " Mops/s" << std::endl;
+
+        if (threads == max_threads) {
+            break;
+        }
+    }
+
+    std::cout << std::endl << ht->ToString() << std::endl;
+
+    delete ht;
+}
+
+template <typename Table>
+void BenchmarkReaders(const std::string& name, std::default_random_engine& dre) {
+    const int WORD_COUNT = 6;
+    const int KEY_COUNT = 1000000;
+    const int OPS_PER_THREAD = 1000000;
+
+    std::uniform_int_distribution<int> rnd_num(0, KEY_COUNT);
+
+    std::vector<typename Table::Key> keys(KEY_COUNT);
+    for (int j = 0; j < KEY_COUNT; j++) {
+        keys[j] = GenerateKey<typename Table::Key>(dre, WORD_COUNT);
+    }
+
+    Table* ht = new Table();
+    for (int j = 0; j < KEY_COUNT; j += 2) {
+        ht->Push(keys[j], rnd_num(dre));
+    }
+
+    unsigned int max_threads = std::thread::hardware_concurrency();
+    if (!max_threads) {
+        max_threads = 1;
+    }
+
+    std::cout << "--------------------------------" << std::endl;
+    std::cout << name << " readers test (1 writer)" << std::endl << std::endl;
+
+    for (unsigned int threads = 1;; threads *= 2) {
+        if (threads > max_threads) {
+            threads = max_threads;
+        }
+
+        std::atomic<bool> stop(false);
+        std::thread writer([ht, &keys, &stop]() {
+            std::default_random_engine engine(0);
+            std::uniform_int_distribution<int> rnd_key(0, KEY_COUNT - 1);
+
+            for (int j = 0; !stop.load(std::memory_order_relaxed); j++) {
+                const typename Table::Key& key = keys[rnd_key(engine)];
+                if (j % 2) {
+                    ht->Push(key, j);
+                }
+                else {
+                    ht->Pop(key);
+                }
+            }
+        });
+
+        std::vector<std::thread> readers;
+        std::chrono::high_resolution_clock::time_point start_time = std::chrono::high_resolution_clock::now();
+        for (unsigned int t = 0; t < threads; t++) {
+            readers.emplace_back([ht, &keys, t]() {
+                std::default_random_engine engine(t + 1);
+                std::uniform_int_distribution<int> rnd_key(0, KEY_COUNT - 1);
+                int hits = 0;
+
+                for (int j = 0; j < OPS_PER_THREAD; j++) {
+                    hits += ht->Contains(keys[rnd_key(engine)]);
+                }
+
+                if (hits < 0) {
+                    std::cerr << "Unreachable" << std::endl;
+                }
+            });
+        }
+        for (std::thread& reader : readers) {
+            reader.join();
+        }
+        std::chrono::high_resolution_clock::time_point end_time = std::chrono::high_resolution_clock::now();
+
+        stop.store(true);
+        writer.join();
+
+        std::chrono::duration<double> time = end_time - start_time;
+        double ops = double(threads) * OPS_PER_THREAD / time.count();
+        std::cout << "Readers: " << threads << ", time: " << time.count() << "s, " << ops / 1e6 << " Mops/s" << std::endl;
+
+        if (threads == max_threads) {
+            break;
+        }
+    }
+
+    std::cout << std::endl << ht->ToString() << std::endl;
+
+    delete ht;
+}
+
+template <typename Table>
+void BenchmarkBatch(const std::string& name, std::default_random_engine& dre) {
+    const int WORD_COUNT = 6;
+    const int KEY_COUNT = 1 << 22;
+    const int FIND_COUNT = 1 << 22;
+
+    std::uniform_int_distribution<int> rnd_num(0, KEY_COUNT);
+    std::uniform_int_distribution<int> rnd_index(0, KEY_COUNT - 1);
+
+    std::vector<typename Table::Key> keys(KEY_COUNT);
+    std::vector<int> values(KEY_COUNT);
+    for (int j = 0; j < KEY_COUNT; j++) {
+        keys[j] = GenerateKey<typename Table::Key>(dre, WORD_COUNT);
+        values[j] = rnd_num(dre);
+    }
+
+    std::cout << "--------------------------------" << std::endl;
+    std::cout << name << " batch test (" << KEY_COUNT << " keys)" << std::endl << std::endl;
+
+    Table* ht = new Table();
+
+    std::chrono::high_resolution_clock::time_point start_time = std::chrono::high_resolution_clock::now();
+    for (int j = 0; j < KEY_COUNT; j++) {
+        ht->Push(keys[j], values[j]);
+    }
+    std::chrono::high_resolution_clock::time_point end_time = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> push_time = end_time - start_time;
+
+    delete ht;
+    ht = new Table();
+
+    start_time = std::chrono::high_resolution_clock::now();
+    ht->PushBatch(keys.data(), values.data(), KEY_COUNT);
+    end_time = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> push_batch_time = end_time - start_time;
+
+    std::cout << "Push: " << push_time.count() << "s, PushBatch: " << push_batch_time.count() << "s, speedup: " << push_time.count() / push_batch_time.count() << "x" << std::endl;
+
+    std::vector<typename Table::Key> find_keys(FIND_COUNT);
+    for (int j = 0; j < FIND_COUNT; j++) {
+        find_keys[j] = keys[rnd_index(dre)];
+    }
+
+    int hits = 0;
+    start_time = std::chrono::high_resolution_clock::now();
+    for (int j = 0; j < FIND_COUNT; j++) {
+        if (ht->Find(find_keys[j])) {
+            hits++;
+        }
+    }
+    end_time = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> find_time = end_time - start_time;
+
+    const int CHUNK = 1024;
+    std::vector<typename Table::Node*> found(CHUNK);
+    int batch_hits = 0;
+    start_time = std::chrono::high_resolution_clock::now();
+    for (int j = 0; j < FIND_COUNT; j += CHUNK) {
+        ht->FindBatch(find_keys.data() + j, CHUNK, found.data());
+        for (int k = 0; k < CHUNK; k++) {
+            if (found[k]) {
+                batch_hits++;
+            }
+        }
+    }
+    end_time = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> find_batch_time = end_time - start_time;
+
+    std::cout << "Find: " << find_time.count() << "s, FindBatch: " << find_batch_time.count() << "s, speedup: " << find_time.count() / find_batch_time.count() << "x" << std::endl;
+    if (hits != batch_hits) {
+        std::cerr << "FindBatch hits (" << batch_hits << ") differ from Find hits (" << hits << ")" << std::endl;
+    }
+    std::cout << std::endl;
+
+    delete ht;
+}
+
+template <typename Table>
+void BenchmarkBuild(const std::string& name, std::default_random_engine& dre) {
+    const int WORD_COUNT = 6;
+    const int KEY_COUNT = 1 << 22;
+
+    std::uniform_int_distribution<int> rnd_num(0, KEY_COUNT);
+
+    std::vector<std::pair<typename Table::Key, int>> items(KEY_COUNT);
+    for (int j = 0; j < KEY_COUNT; j++) {
+        items[j] = { GenerateKey<typename Table::Key>(dre, WORD_COUNT), rnd_num(dre) };
+    }
+
+    std::cout << "--------------------------------" << std::endl;
+    std::cout << name << " build test (" << KEY_COUNT << " keys)" << std::endl << std::endl;
+
+    std::chrono::high_resolution_clock::time_point start_time = std::chrono::high_resolution_clock::now();
+    Table* ht = new Table();
+    for (const auto& item : items) {
+        ht->Push(item.first, item.second);
+    }
+    std::chrono::high_resolution_clock::time_point end_time = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> push_time = end_time - start_time;
+    delete ht;
+
+    start_time = std::chrono::high_resolution_clock::now();
+    ht = new Table(items.size());
+    for (const auto& item : items) {
+        ht->Push(item.first, item.second);
+    }
+    end_time = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> reserved_time = end_time - start_time;
+    delete ht;
+
+    start_time = std::chrono::high_resolution_clock::now();
+    ht = new Table(items.begin(), items.end());
+    end_time = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> bulk_time = end_time - start_time;
+
+    std::cout << "Push: " << push_time.count() << "s" << std::endl;
+    std::cout << "Reserved push: " << reserved_time.count() << "s" << std::endl;
+    std::cout << "Bulk build (" << std::thread::hardware_concurrency() << " threads): " << bulk_time.count() << "s" << std::endl;
+    std::cout << std::endl << ht->ToString(1) << std::endl;
+
+    delete ht;
+}
+
+template <typename Table, typename Snapshot>
+void BenchmarkSnapshot(const std::string& name, std::default_random_engine& dre) {
+    const int WORD_COUNT = 6;
+    const int KEY_COUNT = 1 << 22;
+    const char* PATH = "Hash_Table.snap";
+
+    std::uniform_int_distribution<int> rnd_num(0, KEY_COUNT);
+
+    std::vector<typename Table::Key> keys(KEY_COUNT);
+    for (int j = 0; j < KEY_COUNT; j++) {
+        keys[j] = GenerateKey<typename Table::Key>(dre, WORD_COUNT);
+    }
+
+    std::cout << "--------------------------------" << std::endl;
+    std::cout << name << " snapshot test (" << KEY_COUNT << " keys)" << std::endl << std::endl;
+
+    std::chrono::high_resolution_clock::time_point start_time = std::chrono::high_resolution_clock::now();
+    Table* ht = new Table();
+    for (int j = 0; j < KEY_COUNT; j++) {
+        ht->Push(keys[j], rnd_num(dre));
+    }
+    std::chrono::high_resolution_clock::time_point end_time = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> push_time = end_time - start_time;
+
+    start_time = std::chrono::high_resolution_clock::now();
+    SNAP::Save(*ht, std::string(PATH));
+    end_time = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> save_time = end_time - start_time;
+
+    start_time = std::chrono::high_resolution_clock::now();
+    Snapshot* snapshot = new Snapshot(PATH);
+    end_time = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> open_time = end_time - start_time;
+
+    int hits = 0;
+    start_time = std::chrono::high_resolution_clock::now();
+    for (int j = 0; j < KEY_COUNT; j++) {
+        if (snapshot->Find(keys[j])) {
+            hits++;
+        }
+    }
+    end_time = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> find_time = end_time - start_time;
+
+    Table* loaded = new Table();
+    start_time = std::chrono::high_resolution_clock::now();
+    snapshot->Load(*loaded);
+    end_time = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> load_time = end_time - start_time;
+
+    std::cout << "Pushing time: " << push_time.count() << "s" << std::endl;
+    std::cout << "Save time: " << save_time.count() << "s" << std::endl;
+    std::cout << "Open time: " << open_time.count() << "s" << std::endl;
+    std::cout << "Mapped find time (cold): " << find_time.count() << "s, hits: " << hits << std::endl;
+    std::cout << "Load into table time: " << load_time.count() << "s, elements: " << loaded->Elements() << std::endl;
+    std::cout << std::endl << snapshot->ToString() << std::endl;
+
+    delete loaded;
+    delete snapshot;
+    delete ht;
+    std::remove(PATH);
+}
+
+template <typename Table>
+void BenchmarkFreeze(const std::string& name, std::default_random_engine& dre) {
+    const int WORD_COUNT = 6;
+    const int KEY_COUNT = 1 << 22;
+
+    std::uniform_int_distribution<int> rnd_num(0, KEY_COUNT);
+
+    std::vector<typename Table::Key> keys(KEY_COUNT);
+    for (int j = 0; j < KEY_COUNT; j++) {
+        keys[j] = GenerateKey<typename Table::Key>(dre, WORD_COUNT);
+    }
+
+    std::cout << "--------------------------------" << std::endl;
+    std::cout << name << " freeze test (" << KEY_COUNT << " keys)" << std::endl << std::endl;
+
+    Table* ht = new Table();
+    for (int j = 0; j < KEY_COUNT; j++) {
+        ht->Push(keys[j], rnd_num(dre));
+    }
+
+    std::chrono::high_resolution_clock::time_point start_time = std::chrono::high_resolution_clock::now();
+    auto frozen = ht->Freeze();
+    std::chrono::high_resolution_clock::time_point end_time = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> freeze_time = end_time - start_time;
+
+    int hits = 0;
+    start_time = std::chrono::high_resolution_clock::now();
+    for (int j = 0; j < KEY_COUNT; j++) {
+        if (ht->Find(keys[j])) {
+            hits++;
+        }
+    }
+    end_time = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> find_time = end_time - start_time;
+
+    int frozen_hits = 0;
+    start_time = std::chrono::high_resolution_clock::now();
+    for (int j = 0; j < KEY_COUNT; j++) {
+        if (frozen.Find(keys[j])) {
+            frozen_hits++;
+        }
+    }
+    end_time = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> frozen_find_time = end_time - start_time;
+
+    std::cout << "Freeze time: " << freeze_time.count() << "s" << std::endl;
+    std::cout << "Index overhead: " << frozen.BitsPerKey() << " bits per key" << std::endl;
+    std::cout << "Find time: " << find_time.count() << "s, hits: " << hits << std::endl;
+    std::cout << "Frozen find time: " << frozen_find_time.count() << "s, hits: " << frozen_hits << std::endl;
+    std::cout << std::endl << frozen.ToString() << std::endl;
+
+    delete ht;
+}
+
+template <typename Table>
+void BenchmarkSort(const std::string& name, std::default_random_engine& dre) {
+    const int WORD_COUNT = 6;
+    const int KEY_COUNT = 1 << 20;
+    const size_t TOP_COUNT = 100;
+
+    std::uniform_int_distribution<int> rnd_num(0, KEY_COUNT);
+
+    Table* ht = new Table();
+    for (int j = 0; j < KEY_COUNT; j++) {
+        ht->Push(GenerateKey<typename Table::Key>(dre, WORD_COUNT), rnd_num(dre));
+    }
+
+    std::cout << "--------------------------------" << std::endl;
+    std::cout << name << " sort test (" << ht->Elements() << " keys by frequency)" << std::endl << std::endl;
+
+    using Item = std::pair<typename Table::Key, int>;
+    auto by_frequency = [](const Item& left, const Item& right) { return left.second < right.second; };
+
+    DA::DynArr<Item> items;
+    auto dump = [ht, &items]() {
+        items.Erase();
+        items.Reserve(ht->Elements());
+        ht->ForEach([&items](const typename Table::Node& node) { items.Push(Item(node.key, node.value)); });
+    };
+
+    dump();
+    std::chrono::high_resolution_clock::time_point start_time = std::chrono::high_resolution_clock::now();
+    items.Sort(by_frequency);
+    std::chrono::high_resolution_clock::time_point end_time = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> sort_time = end_time - start_time;
+
+    dump();
+    start_time = std::chrono::high_resolution_clock::now();
+    items.StableSort(by_frequency);
+    end_time = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> stable_time = end_time - start_time;
+
+    dump();
+    start_time = std::chrono::high_resolution_clock::now();
+    items.PartialSort(TOP_COUNT, by_frequency);
+    end_time = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> partial_time = end_time - start_time;
+
+    DA::DynArr<int> frequencies(ht->Elements());
+    ht->ForEach([&frequencies](const typename Table::Node& node) { frequencies.Push(node.value); });
+    start_time = std::chrono::high_resolution_clock::now();
+    frequencies.Sort();
+    end_time = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> radix_time = end_time - start_time;
+
+    std::cout << "Sort (" << std::thread::hardware_concurrency() << " threads): " << sort_time.count() << "s" << std::endl;
+    std::cout << "Stable sort: " << stable_time.count() << "s" << std::endl;
+    std::cout << "Partial sort (top " << TOP_COUNT << "): " << partial_time.count() << "s" << std::endl;
+    std::cout << "Radix sort (frequencies only): " << radix_time.count() << "s" << std::endl << std::endl;
+
+    delete ht;
+}
+
+template <typename Cache>
+void BenchmarkCache(const std::string& name, std::default_random_engine& dre) {
+    const int WORD_COUNT = 6;
+    const int KEY_COUNT = 1 << 20;
+    const int OP_COUNT = 1 << 22;
+    const double ZIPF_SKEW = 0.99;
+
+    std::vector<typename Cache::Key> keys(KEY_COUNT);
+    for (int j = 0; j < KEY_COUNT; j++) {
+        keys[j] = GenerateKey<typename Cache::Key>(dre, WORD_COUNT);
+    }
+
+    std::vector<double> zipf(KEY_COUNT);
+    double total = 0.0;
+    for (int j = 0; j < KEY_COUNT; j++) {
+        total += 1.0 / pow(double(j + 1), ZIPF_SKEW);
+        zipf[j] = total;
+    }
+
+    std::uniform_real_distribution<double> rnd_real(0.0, total);
+    std::vector<int> trace(OP_COUNT);
+    for (int j = 0; j < OP_COUNT; j++) {
+        trace[j] = int(std::lower_bound(zipf.begin(), zipf.end(), rnd_real(dre)) - zipf.begin());
+    }
+
+    std::cout << "--------------------------------" << std::endl;
+    std::cout << name << " cache test (" << OP_COUNT << " zipf lookups over " << KEY_COUNT << " keys)" << std::endl << std::endl;
+
+    for (int percent : { 1, 10 }) {
+        Cache* cache = new Cache(size_t(KEY_COUNT) * percent / 100);
+
+        std::chrono::high_resolution_clock::time_point start_time = std::chrono::high_resolution_clock::now();
+        for (int j = 0; j < OP_COUNT; j++) {
+            if (!cache->Find(keys[trace[j]])) {
+                cache->Push(keys[trace[j]], trace[j]);
+            }
+        }
+        std::chrono::high_resolution_clock::time_point end_time = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double> time = end_time - start_time;
+
+        std::cout << "Capacity " << percent << "%: hit ratio " << cache->Statistics().HitRatio() << ", evictions " << cache->Statistics().evictions;
+        std::cout << ", " << double(OP_COUNT) / time.count() / 1e6 << " Mops/s" << std::endl;
+
+        delete cache;
+    }
+    std::cout << std::endl;
+}
+
+struct BenchmarkClock {
+    const uint64_t* now;
+
+    uint64_t operator()() const {
+        return *now;
+    }
+};
+
+template <typename Table>
+void BenchmarkExpiry(const std::string& name, std::default_random_engine& dre) {
+    const int WORD_COUNT = 6;
+    const int KEY_COUNT = 1 << 20;
+    const uint64_t MAX_TTL = 1 << 16;
+
+    std::uniform_int_distribution<uint64_t> rnd_ttl(1, MAX_TTL);
+
+    uint64_t now = 0;
+    Table* ht = new Table(KEY_COUNT, BenchmarkClock{ &now });
+
+    std::cout << "--------------------------------" << std::endl;
+    std::cout << name << " expiry test (" << KEY_COUNT << " keys, ttl up to " << MAX_TTL << " ticks)" << std::endl << std::endl;
+
+    std::chrono::high_resolution_clock::time_point start_time = std::chrono::high_resolution_clock::now();
+    for (int j = 0; j < KEY_COUNT; j++) {
+        ht->Push(GenerateKey<typename Table::Key>(dre, WORD_COUNT), j, rnd_ttl(dre));
+    }
+    std::chrono::high_resolution_clock::time_point end_time = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> push_time = end_time - start_time;
+
+    std::chrono::duration<double> worst_tick(0);
+    start_time = std::chrono::high_resolution_clock::now();
+    for (now = 1; now <= MAX_TTL; now++) {
+        std::chrono::high_resolution_clock::time_point tick_start = std::chrono::high_resolution_clock::now();
+        ht->Tick(now);
+        std::chrono::duration<double> tick_time = std::chrono::high_resolution_clock::now() - tick_start;
+        worst_tick = tick_time > worst_tick ? tick_time : worst_tick;
+    }
+    end_time = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> expire_time = end_time - start_time;
+
+    std::cout << "Push time: " << push_time.count() << "s" << std::endl;
+    std::cout << "Expire time: " << expire_time.count() << "s, worst tick: " << worst_tick.count() * 1e6 << "us" << std::endl;
+    std::cout << "Left: " << ht->Elements() << ", expired: " << ht->Expired() << std::endl << std::endl;
+
+    delete ht;
+}
+
+template <typename Table>
+void BenchmarkFootprint(const std::string& name, std::default_random_engine& dre) {
+    const int WORD_COUNT = 6;
+
+    std::cout << "--------------------------------" << std::endl;
+    std::cout << name << " footprint test" << std::endl << std::endl;
+
+    for (int n : { 1000000, 4000000 }) {
+        std::vector<typename Table::Key> keys(n);
+        for (int j = 0; j < n; j++) {
+            keys[j] = GenerateKey<typename Table::Key>(dre, WORD_COUNT);
+        }
+
+        size_t heap_before = HeapInUse();
+        Table* ht = new Table();
+        for (int j = 0; j < n; j++) {
+            ht->Push(keys[j], j);
+        }
+        size_t heap_bytes = HeapInUse() - heap_before;
+
+        std::cout << n << " keys: " << heap_bytes / (1024 * 1024) << " MiB, " << double(heap_bytes) / double(ht->Elements()) << " bytes per entry" << std::endl;
+
+        delete ht;
+    }
+    std::cout << std::endl;
+}
+
+int main() {
+    static std::random_device rd;
+    static std::default_random_engine dre(rd());
+
+    Benchmark<HT::HashTable<int, HF::Polynomial>>("Chaining (polynomial)", dre);
+    Benchmark<HT::HashTable<int, HF::FNV1a>>("Chaining (FNV-1a)", dre);
+    Benchmark<HT::HashTable<int, HF::WyHash>>("Chaining (wyhash)", dre);
+    Benchmark<HT::HashTable<int, HF::WyHash, HT::IntrusiveChaining>>("Intrusive chaining (wyhash)", dre);
+    Benchmark<HT::HashTable<int, HF::WyHash, HT::UnrolledChaining>>("Unrolled chaining (wyhash)", dre);
+    Benchmark<HT::HashTable<int, HF::WyHash, HT::ListChaining, HT::LiveStats>>("Chaining (wyhash, live stats)", dre);
+    Benchmark<HT::HashTable<int, HF::WyHash, HT::ListChaining, HT::NoStats, HT::BloomFilter>>("Chaining (wyhash, bloom filter)", dre);
+    Benchmark<FHT::FlatHashTable<int>>("Flat", dre);
+    Benchmark<FHT::CompactHashTable<int>>("Compact keys", dre);
+    Benchmark<HT::HashMap<uint64_t, int>>("Chaining (uint64_t keys)", dre);
+    Benchmark<HT::HashMap<uint64_t, int, HF::Hash<uint64_t>, HF::Equal<uint64_t>, HT::IntrusiveChaining>>("Intrusive chaining (uint64_t keys)", dre);
+    Benchmark<FHT::FlatHashMap<uint64_t, int>>("Flat (uint64_t keys)", dre);
+
+    BenchmarkBatch<HT::HashTable<int>>("Chaining", dre);
+    BenchmarkBatch<HT::HashTable<int, HF::WyHash, HT::IntrusiveChaining>>("Intrusive chaining", dre);
+    BenchmarkBatch<HT::HashMap<uint64_t, int, HF::Hash<uint64_t>, HF::Equal<uint64_t>, HT::IntrusiveChaining>>("Intrusive chaining (uint64_t keys)", dre);
+
+    BenchmarkBuild<HT::HashTable<int>>("Chaining", dre);
+    BenchmarkBuild<HT::HashMap<uint64_t, int, HF::Hash<uint64_t>, HF::Equal<uint64_t>, HT::IntrusiveChaining>>("Intrusive chaining (uint64_t keys)", dre);
+
+    BenchmarkFootprint<HT::HashTable<int>>("Chaining", dre);
+    BenchmarkFootprint<HT::HashTable<int, HF::WyHash, HT::IntrusiveChaining>>("Intrusive chaining", dre);
+    BenchmarkFootprint<FHT::FlatHashTable<int>>("Flat", dre);
+    BenchmarkFootprint<FHT::CompactHashTable<int>>("Compact keys", dre);
+
+    BenchmarkSnapshot<HT::HashTable<int>, SNAP::TableSnapshot<int>>("Chaining", dre);
+
+    BenchmarkFreeze<HT::HashTable<int>>("Chaining", dre);
+    BenchmarkFreeze<HT::HashMap<uint64_t, int>>("Chaining (uint64_t keys)", dre);
+
+    BenchmarkSort<HT::HashTable<int>>("Chaining", dre);
+
+    BenchmarkCache<LRU::Cache<std::string, int>>("LRU", dre);
+    BenchmarkCache<LRU::Cache<std::string, int, LRU::Clock>>("CLOCK", dre);
+
+    BenchmarkExpiry<TTL::ExpiringTable<int, BenchmarkClock>>("Timer wheel", dre);
+
+    BenchmarkThreads<SHT::ShardedHashTable<int>>("Sharded", dre);
+    BenchmarkThreads<SHT::ShardedHashMap<uint64_t, int>>("Sharded (uint64_t keys)", dre);
+
+    BenchmarkReaders<SHT::ShardedHashTable<int>>("Sharded", dre);
+    BenchmarkReaders<LFHT::LockFreeHashTable<int>>("Lock-free read", dre);
+
+    return find_allocated ? EXIT_FAILURE : EXIT_SUCCESS;
 }
\ No newline at end of file
@@ -0,0 +1,264 @@
+#pragma once
+#include <string>
+#include <stdexcept>
+#include <atomic>
+#include <mutex>
+#include "HF.h"
+#include "EBR.h"
+
+namespace LFHT {
+
+	template <typename K, typename T, typename Hash = HF::Hash<K>, typename KeyEqual = HF::Equal<K>>
+	class LockFreeHashMap {
+
+		template <typename Q>
+		using EnableIfTransparent = std::enable_if_t<!std::is_void_v<Q> && HF::IsTransparent<Hash, KeyEqual>::value, int>;
+
+		struct Node {
+			uint64_t hash;
+			K key;
+			T value;
+			std::atomic<Node*> next;
+
+			Node(uint64_t in_hash, K in_key, T in_value, Node* in_next) : hash(in_hash), key(in_key), value(in_value), next(in_next) {}
+		};
+
+		struct Array {
+			size_t capacity;
+			std::atomic<Node*>* buckets;
+
+			Array(size_t in_capacity) : capacity(in_capacity), buckets(new std::atomic<Node*>[in_capacity]) {
+				for (size_t i = 0; i < capacity; i++) {
+					buckets[i].store(nullptr, std::memory_order_relaxed);
+				}
+			}
+
+			~Array() {
+				delete[] buckets;
+			}
+		};
+
+		const double FACTOR = 0.75;
+		Hash _hash;
+		KeyEqual _equal;
+		std::atomic<Array*> _array;
+		std::atomic<size_t> _elements;
+		std::mutex _write_mutex;
+		EBR::Domain& _domain;
+
+		template <typename Q>
+		Node* FindNode(const Array* array, uint64_t hash, const Q& key) const {
+			Node* node = array->buckets[size_t(hash) & (array->capacity - 1)].load(std::memory_order_acquire);
+
+			while (node) {
+				if (node->hash == hash && _equal(node->key, key)) {
+					return node;
+				}
+				node = node->next.load(std::memory_order_acquire);
+			}
+
+			return nullptr;
+		}
+
+		template <typename Q>
+		std::atomic<Node*>* FindLink(Array* array, uint64_t hash, const Q& key) {
+			std::atomic<Node*>* link = &array->buckets[size_t(hash) & (array->capacity - 1)];
+
+			for (Node* node = link->load(std::memory_order_relaxed); node; node = link->load(std::memory_order_relaxed)) {
+				if (node->hash == hash && _equal(node->key, key)) {
+					return link;
+				}
+				link = &node->next;
+			}
+
+			return nullptr;
+		}
+
+		static void DeleteArray(Array* array) {
+			for (size_t i = 0; i < array->capacity; i++) {
+				Node* node = array->buckets[i].load(std::memory_order_relaxed);
+				while (node) {
+					Node* next = node->next.load(std::memory_order_relaxed);
+					delete node;
+					node = next;
+				}
+			}
+			delete array;
+		}
+
+		// The array owns every node in its chains, so it is retired as one item that frees them all.
+		void RetireArray(Array* array) {
+			_domain.Retire(array, [](void* ptr) { DeleteArray(static_cast<Array*>(ptr)); });
+		}
+
+		void ExpandAndReHash() {
+			Array* old_array = _array.load(std::memory_order_relaxed);
+			Array* new_array = nullptr;
+
+			try {
+				new_array = new Array(old_array->capacity * 2);
+
+				for (size_t i = 0; i < old_array->capacity; i++) {
+					for (Node* node = old_array->buckets[i].load(std::memory_order_relaxed); node; node = node->next.load(std::memory_order_relaxed)) {
+						std::atomic<Node*>& bucket = new_array->buckets[size_t(node->hash) & (new_array->capacity - 1)];
+						bucket.store(new Node(node->hash, node->key, node->value, bucket.load(std::memory_order_relaxed)), std::memory_order_relaxed);
+					}
+				}
+			}
+			catch (const std::bad_alloc& ex) {
+				if (new_array) {
+					DeleteArray(new_array);
+				}
+				throw std::runtime_error("LFHT::ExpandAndReHash() -> " + std::string(ex.what()));
+			}
+
+			_array.store(new_array, std::memory_order_release);
+			RetireArray(old_array);
+		}
+
+		template <typename Q>
+		bool FindKey(const Q& key, T& out) const {
+			uint64_t hash = _hash(key);
+			EBR::Domain::Guard guard(_domain);
+
+			if (Node* node = FindNode(_array.load(std::memory_order_acquire), hash, key)) {
+				out = node->value;
+				return true;
+			}
+			return false;
+		}
+
+		template <typename Q>
+		bool ContainsKey(const Q& key) const {
+			uint64_t hash = _hash(key);
+			EBR::Domain::Guard guard(_domain);
+
+			return FindNode(_array.load(std::memory_order_acquire), hash, key) != nullptr;
+		}
+
+		template <typename Q>
+		void PopKey(const Q& key) {
+			uint64_t hash = _hash(key);
+			std::lock_guard<std::mutex> lock(_write_mutex);
+
+			if (std::atomic<Node*>* link = FindLink(_array.load(std::memory_order_relaxed), hash, key)) {
+				Node* node = link->load(std::memory_order_relaxed);
+				link->store(node->next.load(std::memory_order_relaxed), std::memory_order_release);
+				_elements.fetch_sub(1, std::memory_order_relaxed);
+
+				try {
+					_domain.Retire(node);
+				}
+				catch (const std::exception& ex) {
+					throw std::runtime_error("LFHT::Pop() -> " + std::string(ex.what()));
+				}
+			}
+		}
+
+	public:
+		using Key = K;
+
+		LockFreeHashMap() : _array(nullptr), _elements(0), _domain(EBR::Domain::Global()) {
+			try {
+				_array.store(new Array(1024));
+			}
+			catch (const std::bad_alloc& ex) {
+				throw std::runtime_error("LFHT::LockFreeHashMap() -> " + std::string(ex.what()));
+			}
+		}
+
+		~LockFreeHashMap() {
+			DeleteArray(_array.load());
+		}
+
+		LockFreeHashMap(const LockFreeHashMap&) = delete;
+		LockFreeHashMap& operator=(const LockFreeHashMap&) = delete;
+
+		size_t Elements() const {
+			return _elements.load(std::memory_order_relaxed);
+		}
+
+		size_t Capacity() const {
+			return _array.load(std::memory_order_acquire)->capacity;
+		}
+
+		void Push(K key, T value) {
+			uint64_t hash = _hash(key);
+			std::lock_guard<std::mutex> lock(_write_mutex);
+			Array* array = _array.load(std::memory_order_relaxed);
+
+			try {
+				if (std::atomic<Node*>* link = FindLink(array, hash, key)) {
+					Node* old_node = link->load(std::memory_order_relaxed);
+					link->store(new Node(hash, old_node->key, value, old_node->next.load(std::memory_order_relaxed)), std::memory_order_release);
+					_domain.Retire(old_node);
+					return;
+				}
+
+				std::atomic<Node*>& bucket = array->buckets[size_t(hash) & (array->capacity - 1)];
+				bucket.store(new Node(hash, key, value, bucket.load(std::memory_order_relaxed)), std::memory_order_release);
+				_elements.fetch_add(1, std::memory_order_relaxed);
+
+				if (_elements.load(std::memory_order_relaxed) > array->capacity * FACTOR) {
+					ExpandAndReHash();
+				}
+			}
+			catch (const std::exception& ex) {
+				throw std::runtime_error("LFHT::Push() -> " + std::string(ex.what()));
+			}
+		}
+
+		bool Find(const K& key, T& out) const {
+			return FindKey(key, out);
+		}
+
+		template <typename Q, EnableIfTransparent<Q> = 0>
+		bool Find(const Q& key, T& out) const {
+			return FindKey(key, out);
+		}
+
+		bool Contains(const K& key) const {
+			return ContainsKey(key);
+		}
+
+		template <typename Q, EnableIfTransparent<Q> = 0>
+		bool Contains(const Q& key) const {
+			return ContainsKey(key);
+		}
+
+		void Pop(const K& key) {
+			PopKey(key);
+		}
+
+		template <typename Q, EnableIfTransparent<Q> = 0>
+		void Pop(const Q& key) {
+			PopKey(key);
+		}
+
+		void Erase() {
+			std::lock_guard<std::mutex> lock(_write_mutex);
+			Array* old_array = _array.load(std::memory_order_relaxed);
+
+			try {
+				_array.store(new Array(old_array->capacity), std::memory_order_release);
+				_elements.store(0, std::memory_order_relaxed);
+				RetireArray(old_array);
+			}
+			catch (const std::exception& ex) {
+				throw std::runtime_error("LFHT::Erase() -> " + std::string(ex.what()));
+			}
+		}
+
+		std::string ToString() const {
+			std::string text = ">>> Lock-Free Read Hash Table <<<\n";
+			text += "> elements: " + std::to_string(int(Elements())) + "\n";
+			text += "> capacity: " + std::to_string(int(Capacity())) + "\n";
+			text += "> pending reclamation: " + std::to_string(int(_domain.Pending())) + "\n";
+
+			return text;
+		}
+	};
+
+	template <typename T, typename Hash = HF::Hash<std::string>>
+	using LockFreeHashTable = LockFreeHashMap<std::string, T, Hash>;
+}
\ No newline at end of file
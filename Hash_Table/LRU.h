@@ -0,0 +1,298 @@
+#pragma once
+#include <string>
+#include <stdexcept>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+#include "HT.h"
+#include "DLL.h"
+
+namespace LRU {
+
+	// Charges one unit per entry, so the capacity is an entry count.
+	struct CountEntries {
+		template <typename K, typename T>
+		size_t operator()(const K&, const T&) const {
+			return 1;
+		}
+	};
+
+	// Charges the inline size of key and value plus the contents of anything with size() and
+	// value_type (std::string, std::vector), so the capacity is an approximate byte budget.
+	struct CountBytes {
+		template <typename K, typename T>
+		size_t operator()(const K& key, const T& value) const {
+			return sizeof(K) + sizeof(T) + HeapBytes(key, 0) + HeapBytes(value, 0);
+		}
+
+	private:
+		template <typename C>
+		static auto HeapBytes(const C& container, int) -> decltype(container.size() * sizeof(typename C::value_type)) {
+			return container.size() * sizeof(typename C::value_type);
+		}
+
+		template <typename C>
+		static size_t HeapBytes(const C&, long) {
+			return 0;
+		}
+	};
+
+	// Every hit moves the entry to the front of the recency list and the tail is evicted.
+	struct Exact {
+		static constexpr bool CLOCK = false;
+	};
+
+	// Hits only set a reference bit and never write to the recency list. Eviction walks from the
+	// tail and sends referenced entries back to the front with the bit cleared (second chance).
+	struct Clock {
+		static constexpr bool CLOCK = true;
+	};
+
+	struct Counters {
+		size_t hits = 0;
+		size_t misses = 0;
+		size_t insertions = 0;
+		size_t evictions = 0;
+
+		double HitRatio() const {
+			return hits + misses ? double(hits) / double(hits + misses) : 0.0;
+		}
+	};
+
+	// Bounded cache over an HT::HashMap index. Every entry holds a cursor into a DLL recency list,
+	// so Find is one hash probe plus an O(1) relink, and entries are evicted from the tail once the
+	// total weight reported by Weigher passes the capacity. Not thread safe.
+	template <typename K, typename T, typename Policy = Exact, typename Weigher = CountEntries, typename Hash = HF::Hash<K>, typename KeyEqual = HF::Equal<K>>
+	class Cache {
+
+		struct Entry;
+
+		using List = DLL::DoubLinList<Entry*>;
+		using Cursor = typename List::Cursor;
+
+		struct Entry {
+			T value;
+			const K* key;
+			Cursor cursor;
+			size_t weight;
+			bool referenced;
+
+			template <typename... Args>
+			Entry(std::in_place_t, Args&&... args) : value(std::forward<Args>(args)...), key(nullptr), cursor(), weight(0), referenced(false) {}
+		};
+
+		using Index = HT::HashMap<K, Entry, Hash, KeyEqual, HT::IntrusiveChaining>;
+
+		// Resizes are spread over later operations, so no single Push or eviction pays for a full rehash.
+		static constexpr size_t REHASH_STEP = 64;
+
+		Index _index;
+		typename List::NodePool _list_pool;
+		List _recency;
+		Weigher _weigher;
+		size_t _capacity;
+		size_t _weight;
+		Counters _counters;
+
+		void Touch(Entry& entry) {
+			if constexpr (Policy::CLOCK) {
+				entry.referenced = true;
+			}
+			else {
+				entry.cursor = _recency.MoveToFront(entry.cursor);
+			}
+		}
+
+		void Remove(Entry* entry) {
+			_weight -= entry->weight;
+			_recency.EraseAt(entry->cursor);
+			_index.Pop(*entry->key);
+		}
+
+		// Evicts until the weight fits, never choosing keep (the entry being stored).
+		void Evict(Entry* keep) {
+			while (_weight > _capacity && _recency.Size()) {
+				Entry* victim = List::At(_recency.Last());
+
+				if constexpr (Policy::CLOCK) {
+					while (victim->referenced || victim == keep) {
+						victim->referenced = false;
+						victim->cursor = _recency.MoveToFront(victim->cursor);
+						victim = List::At(_recency.Last());
+					}
+				}
+				else if (victim == keep) {
+					return;
+				}
+
+				Remove(victim);
+				_counters.evictions++;
+			}
+		}
+
+		template <typename KArg, typename M>
+		T* Store(KArg&& key, M&& value) {
+			auto result = _index.TryEmplace(std::forward<KArg>(key), std::in_place, std::forward<M>(value));
+			Entry& entry = result.first->value;
+
+			if (result.second) {
+				entry.key = &result.first->key;
+				try {
+					entry.cursor = _recency.PushFront(&entry);
+				}
+				catch (...) {
+					_index.Pop(*entry.key);
+					throw;
+				}
+				_counters.insertions++;
+			}
+			else {
+				entry.value = std::forward<M>(value);
+				_weight -= entry.weight;
+				Touch(entry);
+			}
+
+			entry.weight = _weigher(*entry.key, entry.value);
+			_weight += entry.weight;
+
+			if (entry.weight > _capacity) {
+				Remove(&entry);
+				return nullptr;
+			}
+
+			Evict(&entry);
+
+			return &entry.value;
+		}
+
+	public:
+		using Key = K;
+
+		Cache(size_t capacity, Weigher weigher = Weigher()) : _index(std::is_same_v<Weigher, CountEntries> ? capacity + 1 : 0), _recency(&_list_pool), _weigher(weigher), _capacity(capacity), _weight(0) {
+			if (!capacity) { throw std::invalid_argument("LRU::Cache(): capacity was zero"); }
+
+			_index.SetReHashStep(REHASH_STEP);
+		}
+
+		Cache(const Cache&) = delete;
+		Cache& operator=(const Cache&) = delete;
+
+		size_t Elements() const {
+			return _index.Elements();
+		}
+
+		size_t Weight() const {
+			return _weight;
+		}
+
+		size_t Capacity() const {
+			return _capacity;
+		}
+
+		void SetCapacity(size_t capacity) {
+			if (!capacity) { throw std::invalid_argument("LRU::SetCapacity(): capacity was zero"); }
+
+			try {
+				_capacity = capacity;
+				Evict(nullptr);
+			}
+			catch (const std::exception& ex) {
+				throw std::runtime_error("LRU::SetCapacity() -> " + std::string(ex.what()));
+			}
+		}
+
+		const Counters& Statistics() const {
+			return _counters;
+		}
+
+		void ResetStatistics() {
+			_counters = Counters();
+		}
+
+		// Inserts or replaces the value and marks it as most recently used. Returns null when the
+		// entry alone weighs more than the capacity and was not kept.
+		template <typename M>
+		T* Push(const K& key, M&& value) {
+			try {
+				return Store(key, std::forward<M>(value));
+			}
+			catch (const std::exception& ex) {
+				throw std::runtime_error("LRU::Push() -> " + std::string(ex.what()));
+			}
+		}
+
+		template <typename M>
+		T* Push(K&& key, M&& value) {
+			try {
+				return Store(std::move(key), std::forward<M>(value));
+			}
+			catch (const std::exception& ex) {
+				throw std::runtime_error("LRU::Push() -> " + std::string(ex.what()));
+			}
+		}
+
+		// Counts a hit or a miss and marks a found entry as recently used.
+		T* Find(const K& key) {
+			typename Index::Node* node = _index.Find(key);
+			if (!node) {
+				_counters.misses++;
+				return nullptr;
+			}
+
+			_counters.hits++;
+			Touch(node->value);
+
+			return &node->value.value;
+		}
+
+		// Looks the key up without touching recency or the counters.
+		const T* Peek(const K& key) const {
+			typename Index::Node* node = _index.Find(key);
+			return node ? &node->value.value : nullptr;
+		}
+
+		bool Contains(const K& key) const {
+			return _index.Contains(key);
+		}
+
+		bool Pop(const K& key) {
+			typename Index::Node* node = _index.Find(key);
+			if (!node) {
+				return false;
+			}
+
+			try {
+				Remove(&node->value);
+			}
+			catch (const std::exception& ex) {
+				throw std::runtime_error("LRU::Pop() -> " + std::string(ex.what()));
+			}
+
+			return true;
+		}
+
+		// Visits the entries from the most to the least recently used.
+		template <typename Function>
+		void ForEach(Function fn) const {
+			_recency.ForEach([&fn](const Entry* entry) { fn(*entry->key, entry->value); });
+		}
+
+		void Erase() {
+			_recency.Erase();
+			_index.Erase();
+			_weight = 0;
+		}
+
+		std::string ToString() const {
+			std::string text = ">>> LRU Cache <<<\n";
+			text += "> policy: " + std::string(Policy::CLOCK ? "clock" : "exact") + "\n";
+			text += "> elements: " + std::to_string(Elements()) + "\n";
+			text += "> weight: " + std::to_string(_weight) + " / " + std::to_string(_capacity) + "\n";
+			text += "> hits: " + std::to_string(_counters.hits) + ", misses: " + std::to_string(_counters.misses) + "\n";
+			text += "> insertions: " + std::to_string(_counters.insertions) + ", evictions: " + std::to_string(_counters.evictions) + "\n";
+			text += "> hit ratio: " + std::to_string(_counters.HitRatio()) + "\n";
+
+			return text;
+		}
+	};
+}
@@ -0,0 +1,331 @@
+#pragma once
+#include <string>
+#include <stdexcept>
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include <type_traits>
+#include "HF.h"
+
+namespace PHT {
+
+	// Immutable table indexed by a minimal perfect hash. Keys are split into buckets of about
+	// LAMBDA keys and every bucket stores a 16-bit pilot that displaces its keys into free slots
+	// (compress-hash-displace with PTHash-style pilots), so a lookup is one slot probe. Pilots are
+	// searched over n / ALPHA positions; the few that land past n are remapped to the holes below n.
+	// The build retries with a new seed when pilots run out. Keys that share a full 64-bit hash
+	// cannot be told apart by any seed, so they share one slot and _groups lists their nodes.
+	template <typename K, typename T, typename Hash = HF::Hash<K>, typename KeyEqual = HF::Equal<K>>
+	class PerfectHashMap {
+
+		template <typename Q>
+		using EnableIfTransparent = std::enable_if_t<!std::is_void_v<Q> && HF::IsTransparent<Hash, KeyEqual>::value, int>;
+
+	public:
+		struct Node {
+			K key;
+			T value;
+		};
+
+		struct Item {
+			uint64_t hash;
+			const K* key;
+			const T* value;
+		};
+
+	private:
+		static constexpr size_t LAMBDA = 6;
+		static constexpr double ALPHA = 0.99;
+		static constexpr uint32_t MAX_PILOT = 0xffff;
+		static constexpr int MAX_ATTEMPTS = 16;
+
+		Hash _hash;
+		KeyEqual _equal;
+		std::vector<Node> _nodes;
+		std::vector<uint16_t> _pilots;
+		std::vector<uint32_t> _remap;
+		std::vector<uint32_t> _groups;
+		size_t _keys;
+		uint64_t _seed;
+		size_t _dense_buckets;
+
+		static size_t FastRange(uint64_t hash, size_t range) {
+			return size_t((hash >> 32) * uint64_t(range) >> 32);
+		}
+
+		size_t Bucket(uint64_t hash) const {
+			size_t buckets = _pilots.size();
+
+			// About 60% of the keys land in the first 30% of the buckets. Dense buckets are
+			// placed first while most slots are still free, which keeps pilots small.
+			if (uint32_t(hash) < uint32_t(0.6 * 4294967296.0) || _dense_buckets == buckets) {
+				return FastRange(hash, _dense_buckets);
+			}
+			return _dense_buckets + FastRange(hash, buckets - _dense_buckets);
+		}
+
+		uint64_t Remix(uint64_t hash) const {
+			return HF::Mix(hash ^ _seed);
+		}
+
+		uint64_t PilotHash(uint16_t pilot) const {
+			return HF::Mix(_seed + pilot + 1);
+		}
+
+		static size_t Position(uint64_t mixed, uint64_t pilot_hash, size_t slots) {
+			return FastRange((mixed ^ pilot_hash) * 0x9e3779b97f4a7c15ull, slots);
+		}
+
+		size_t Slot(uint64_t mixed) const {
+			size_t position = Position(mixed, PilotHash(_pilots[Bucket(mixed)]), _keys + _remap.size());
+			return position < _keys ? position : _remap[position - _keys];
+		}
+
+		bool TryBuild(const std::vector<uint64_t>& hashes, std::vector<size_t>& slots) {
+			size_t n = hashes.size();
+			size_t m = n + _remap.size();
+			size_t buckets = _pilots.size();
+
+			std::vector<uint64_t> mixed(n);
+			std::vector<size_t> bucket_of(n);
+			std::vector<size_t> sizes(buckets + 1, 0);
+
+			for (size_t i = 0; i < n; i++) {
+				mixed[i] = Remix(hashes[i]);
+				bucket_of[i] = Bucket(mixed[i]);
+				sizes[bucket_of[i] + 1]++;
+			}
+
+			std::vector<size_t> starts(sizes);
+			for (size_t b = 0; b < buckets; b++) {
+				starts[b + 1] += starts[b];
+			}
+
+			std::vector<size_t> members(n);
+			std::vector<size_t> cursor(starts.begin(), starts.end() - 1);
+			for (size_t i = 0; i < n; i++) {
+				members[cursor[bucket_of[i]]++] = i;
+			}
+
+			std::vector<size_t> order(buckets);
+			for (size_t b = 0; b < buckets; b++) {
+				order[b] = b;
+			}
+			std::stable_sort(order.begin(), order.end(), [&sizes](size_t a, size_t b) { return sizes[a + 1] > sizes[b + 1]; });
+
+			std::vector<uint64_t> taken((m + 63) / 64, 0);
+			std::vector<uint64_t> keys;
+			std::vector<size_t> positions;
+
+			for (size_t bucket : order) {
+				size_t begin = starts[bucket];
+				size_t end = starts[bucket + 1];
+				if (begin == end) {
+					continue;
+				}
+
+				keys.clear();
+				for (size_t j = begin; j < end; j++) {
+					keys.push_back(mixed[members[j]]);
+				}
+
+				bool placed = false;
+				for (uint32_t pilot = 0; pilot <= MAX_PILOT && !placed; pilot++) {
+					uint64_t pilot_hash = PilotHash(uint16_t(pilot));
+					positions.clear();
+					placed = true;
+
+					for (uint64_t key : keys) {
+						size_t position = Position(key, pilot_hash, m);
+						if ((taken[position / 64] >> (position % 64)) & 1 || std::find(positions.begin(), positions.end(), position) != positions.end()) {
+							placed = false;
+							break;
+						}
+						positions.push_back(position);
+					}
+
+					if (placed) {
+						_pilots[bucket] = uint16_t(pilot);
+						for (size_t j = begin; j < end; j++) {
+							size_t position = positions[j - begin];
+							taken[position / 64] |= uint64_t(1) << (position % 64);
+							slots[members[j]] = position;
+						}
+					}
+				}
+
+				if (!placed) {
+					return false;
+				}
+			}
+
+			size_t hole = 0;
+			for (size_t i = 0; i < _remap.size(); i++) {
+				if ((taken[(n + i) / 64] >> ((n + i) % 64)) & 1) {
+					while ((taken[hole / 64] >> (hole % 64)) & 1) {
+						hole++;
+					}
+					_remap[i] = uint32_t(hole++);
+				}
+			}
+			for (size_t& slot : slots) {
+				if (slot >= n) {
+					slot = _remap[slot - n];
+				}
+			}
+
+			return true;
+		}
+
+		template <typename Q>
+		const Node* FindKey(const Q& key) const {
+			if (_nodes.empty()) {
+				return nullptr;
+			}
+
+			size_t slot = Slot(Remix(_hash(key)));
+			if (_groups.empty()) {
+				const Node& node = _nodes[slot];
+				return _equal(node.key, key) ? &node : nullptr;
+			}
+
+			for (size_t i = _groups[slot]; i < _groups[slot + 1]; i++) {
+				if (_equal(_nodes[i].key, key)) {
+					return &_nodes[i];
+				}
+			}
+
+			return nullptr;
+		}
+
+	public:
+		using Key = K;
+
+		PerfectHashMap() : _keys(0), _seed(0), _dense_buckets(0) {}
+
+		PerfectHashMap(const std::vector<Item>& items) : _keys(0), _seed(0), _dense_buckets(0) {
+			size_t n = items.size();
+			if (!n) {
+				return;
+			}
+
+			if (n > UINT32_MAX / 2) {
+				throw std::runtime_error("PHT::PerfectHashMap(): too many keys");
+			}
+
+			std::vector<uint64_t> hashes;
+			std::vector<size_t> group_of(n);
+			std::vector<size_t> slots;
+			bool built = false;
+
+			try {
+				std::vector<size_t> by_hash(n);
+				for (size_t i = 0; i < n; i++) {
+					by_hash[i] = i;
+				}
+				std::sort(by_hash.begin(), by_hash.end(), [&items](size_t a, size_t b) { return items[a].hash < items[b].hash; });
+
+				for (size_t i : by_hash) {
+					if (hashes.empty() || hashes.back() != items[i].hash) {
+						hashes.push_back(items[i].hash);
+					}
+					group_of[i] = hashes.size() - 1;
+				}
+
+				_keys = hashes.size();
+				size_t buckets = (_keys + LAMBDA - 1) / LAMBDA;
+				_dense_buckets = buckets > 1 ? std::max<size_t>(1, size_t(0.3 * double(buckets))) : buckets;
+
+				slots.resize(_keys);
+				_nodes.reserve(n);
+				_pilots.assign(buckets, 0);
+				_remap.assign(size_t(double(_keys) / ALPHA) + 1 - _keys, 0);
+
+				for (int attempt = 0; attempt < MAX_ATTEMPTS && !built; attempt++) {
+					_seed = HF::Mix(0x9e3779b97f4a7c15ull * uint64_t(attempt + 1));
+					built = TryBuild(hashes, slots);
+				}
+			}
+			catch (const std::bad_alloc& ex) {
+				throw std::runtime_error("PHT::PerfectHashMap() -> " + std::string(ex.what()));
+			}
+
+			if (!built) {
+				throw std::runtime_error("PHT::PerfectHashMap(): no pilot assignment found");
+			}
+
+			std::vector<size_t> input_of(n);
+			if (_keys == n) {
+				for (size_t i = 0; i < n; i++) {
+					input_of[slots[group_of[i]]] = i;
+				}
+			}
+			else {
+				_groups.assign(_keys + 1, 0);
+				for (size_t i = 0; i < n; i++) {
+					_groups[slots[group_of[i]] + 1]++;
+				}
+				for (size_t slot = 0; slot < _keys; slot++) {
+					_groups[slot + 1] += _groups[slot];
+				}
+
+				std::vector<uint32_t> cursor(_groups.begin(), _groups.end() - 1);
+				for (size_t i = 0; i < n; i++) {
+					input_of[cursor[slots[group_of[i]]]++] = i;
+				}
+			}
+
+			for (size_t position = 0; position < n; position++) {
+				const Item& item = items[input_of[position]];
+				_nodes.push_back({ *item.key, *item.value });
+			}
+		}
+
+		size_t Elements() const {
+			return _nodes.size();
+		}
+
+		size_t Buckets() const {
+			return _pilots.size();
+		}
+
+		double BitsPerKey() const {
+			return _nodes.empty() ? 0.0 : double(_pilots.size() * 16 + (_remap.size() + _groups.size()) * 32) / double(_nodes.size());
+		}
+
+		const Node* Find(const K& key) const {
+			return FindKey(key);
+		}
+
+		template <typename Q, EnableIfTransparent<Q> = 0>
+		const Node* Find(const Q& key) const {
+			return FindKey(key);
+		}
+
+		bool Contains(const K& key) const {
+			return FindKey(key) != nullptr;
+		}
+
+		template <typename Q, EnableIfTransparent<Q> = 0>
+		bool Contains(const Q& key) const {
+			return FindKey(key) != nullptr;
+		}
+
+		const Node* begin() const {
+			return _nodes.data();
+		}
+
+		const Node* end() const {
+			return _nodes.data() + _nodes.size();
+		}
+
+		std::string ToString() const {
+			std::string text = ">>> Perfect Hash Table <<<\n";
+			text += "> elements: " + std::to_string(int(Elements())) + "\n";
+			text += "> buckets: " + std::to_string(int(Buckets())) + "\n";
+			text += "> bits per key: " + std::to_string(BitsPerKey()) + "\n";
+
+			return text;
+		}
+	};
+}
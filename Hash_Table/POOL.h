@@ -0,0 +1,195 @@
+#pragma once
+#include <string>
+#include <stdexcept>
+#include <new>
+#include <utility>
+
+namespace POOL {
+
+	template <typename T>
+	class Pool {
+
+		union Slot {
+			Slot* next;
+			alignas(T) unsigned char data[sizeof(T)];
+		};
+
+		struct alignas(alignof(Slot) > alignof(void*) ? alignof(Slot) : alignof(void*)) Block {
+			Block* next;
+			size_t capacity;
+
+			Slot* Slots() {
+				return reinterpret_cast<Slot*>(this + 1);
+			}
+		};
+
+		// Blocks of an over-aligned T come from the aligned operator new; sizeof(Block) is a multiple of
+		// its alignment, so every slot after the header keeps that alignment too.
+		static constexpr bool OVERALIGNED = alignof(Block) > __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+
+		static void* AllocateBlock(size_t bytes) {
+			if constexpr (OVERALIGNED) {
+				return ::operator new(bytes, std::align_val_t(alignof(Block)));
+			}
+			else {
+				return ::operator new(bytes);
+			}
+		}
+
+		static void FreeBlock(Block* block) {
+			if constexpr (OVERALIGNED) {
+				::operator delete(block, std::align_val_t(alignof(Block)));
+			}
+			else {
+				::operator delete(block);
+			}
+		}
+
+		const size_t BLOCK_BYTES = 64 * 1024;
+		Block* blocks;
+		Slot* free_list;
+		Slot* cursor;
+		Slot* end;
+		size_t allocated;
+		size_t block_count;
+
+		void AddBlock() {
+			size_t capacity = (BLOCK_BYTES - sizeof(Block)) / sizeof(Slot);
+			if (capacity < 1) {
+				capacity = 1;
+			}
+
+			Block* block = nullptr;
+			try {
+				block = static_cast<Block*>(AllocateBlock(sizeof(Block) + capacity * sizeof(Slot)));
+			}
+			catch (const std::bad_alloc& ex) {
+				throw std::runtime_error("POOL::AddBlock() -> " + std::string(ex.what()));
+			}
+
+			block->next = blocks;
+			block->capacity = capacity;
+			blocks = block;
+			block_count++;
+
+			cursor = block->Slots();
+			end = cursor + capacity;
+		}
+
+	public:
+		Pool() : blocks(nullptr), free_list(nullptr), cursor(nullptr), end(nullptr), allocated(0), block_count(0) {}
+
+		~Pool() {
+			Release();
+		}
+
+		Pool(const Pool&) = delete;
+		Pool& operator=(const Pool&) = delete;
+
+		size_t Allocated() const {
+			return allocated;
+		}
+
+		size_t Blocks() const {
+			return block_count;
+		}
+
+		void* Allocate() {
+			Slot* slot = nullptr;
+
+			if (free_list) {
+				slot = free_list;
+				free_list = free_list->next;
+			}
+			else {
+				if (cursor == end) {
+					try {
+						AddBlock();
+					}
+					catch (const std::exception& ex) {
+						throw std::runtime_error("POOL::Allocate() -> " + std::string(ex.what()));
+					}
+				}
+				slot = cursor++;
+			}
+
+			allocated++;
+			return slot;
+		}
+
+		void Deallocate(void* ptr) {
+			Slot* slot = static_cast<Slot*>(ptr);
+			slot->next = free_list;
+			free_list = slot;
+			allocated--;
+		}
+
+		template <typename... Args>
+		T* New(Args&&... args) {
+			void* ptr = Allocate();
+
+			try {
+				return new (ptr) T(std::forward<Args>(args)...);
+			}
+			catch (...) {
+				Deallocate(ptr);
+				throw;
+			}
+		}
+
+		void Delete(T* ptr) {
+			if (ptr) {
+				ptr->~T();
+				Deallocate(ptr);
+			}
+		}
+
+		void Splice(Pool& other) {
+			if (&other == this) {
+				return;
+			}
+
+			if (other.blocks) {
+				Block* last = other.blocks;
+				while (last->next) {
+					last = last->next;
+				}
+				last->next = blocks;
+				blocks = other.blocks;
+			}
+
+			if (other.free_list) {
+				Slot* last = other.free_list;
+				while (last->next) {
+					last = last->next;
+				}
+				last->next = free_list;
+				free_list = other.free_list;
+			}
+
+			allocated += other.allocated;
+			block_count += other.block_count;
+
+			other.blocks = nullptr;
+			other.free_list = nullptr;
+			other.cursor = nullptr;
+			other.end = nullptr;
+			other.allocated = 0;
+			other.block_count = 0;
+		}
+
+		void Release() {
+			while (blocks) {
+				Block* next = blocks->next;
+				FreeBlock(blocks);
+				blocks = next;
+			}
+
+			free_list = nullptr;
+			cursor = nullptr;
+			end = nullptr;
+			allocated = 0;
+			block_count = 0;
+		}
+	};
+}
\ No newline at end of file
@@ -0,0 +1,176 @@
+#pragma once
+#include <string>
+#include <stdexcept>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+#include "HT.h"
+
+namespace SHT {
+
+	template <typename K, typename T, typename Hash = HF::Hash<K>, typename KeyEqual = HF::Equal<K>, typename Chaining = HT::ListChaining>
+	class ShardedHashMap {
+
+		using Table = HT::HashMap<K, T, Hash, KeyEqual, Chaining>;
+
+		template <typename Q>
+		using EnableIfTransparent = std::enable_if_t<!std::is_void_v<Q> && HF::IsTransparent<Hash, KeyEqual>::value, int>;
+
+		struct alignas(64) Shard {
+			mutable std::shared_mutex mutex;
+			Table table;
+		};
+
+		Hash _hash;
+		Shard* _shards;
+		size_t _count;
+
+		static size_t DefaultShards() {
+			size_t threads = std::thread::hardware_concurrency();
+			return threads ? threads * 4 : 16;
+		}
+
+		template <typename Q>
+		Shard& GetShard(const Q& key) const {
+			return _shards[size_t(HF::Mix(_hash(key))) & (_count - 1)];
+		}
+
+		template <typename Q>
+		bool FindKey(const Q& key, T& out) const {
+			Shard& shard = GetShard(key);
+			std::shared_lock<std::shared_mutex> lock(shard.mutex);
+
+			if (auto node = shard.table.Find(key)) {
+				out = node->value;
+				return true;
+			}
+			return false;
+		}
+
+		template <typename Q>
+		bool ContainsKey(const Q& key) const {
+			Shard& shard = GetShard(key);
+			std::shared_lock<std::shared_mutex> lock(shard.mutex);
+
+			return shard.table.Contains(key);
+		}
+
+		template <typename Q>
+		void PopKey(const Q& key) {
+			Shard& shard = GetShard(key);
+			std::unique_lock<std::shared_mutex> lock(shard.mutex);
+
+			try {
+				shard.table.Pop(key);
+			}
+			catch (const std::exception& ex) {
+				throw std::runtime_error("SHT::Pop() -> " + std::string(ex.what()));
+			}
+		}
+
+	public:
+		using Key = K;
+
+		ShardedHashMap(size_t shards = 0) : _shards(nullptr), _count(1) {
+			if (!shards) {
+				shards = DefaultShards();
+			}
+			while (_count < shards) {
+				_count *= 2;
+			}
+
+			try {
+				_shards = new Shard[_count];
+			}
+			catch (const std::exception& ex) {
+				throw std::runtime_error("SHT::ShardedHashMap() -> " + std::string(ex.what()));
+			}
+		}
+
+		~ShardedHashMap() {
+			delete[] _shards;
+		}
+
+		ShardedHashMap(const ShardedHashMap&) = delete;
+		ShardedHashMap& operator=(const ShardedHashMap&) = delete;
+
+		size_t Shards() const {
+			return _count;
+		}
+
+		size_t Elements() const {
+			size_t elements = 0;
+
+			for (size_t i = 0; i < _count; i++) {
+				std::shared_lock<std::shared_mutex> lock(_shards[i].mutex);
+				elements += _shards[i].table.Elements();
+			}
+
+			return elements;
+		}
+
+		void SetReHashStep(size_t step) {
+			for (size_t i = 0; i < _count; i++) {
+				std::unique_lock<std::shared_mutex> lock(_shards[i].mutex);
+				_shards[i].table.SetReHashStep(step);
+			}
+		}
+
+		void Push(K key, T value) {
+			Shard& shard = GetShard(key);
+			std::unique_lock<std::shared_mutex> lock(shard.mutex);
+
+			try {
+				shard.table.Push(key, value);
+			}
+			catch (const std::exception& ex) {
+				throw std::runtime_error("SHT::Push() -> " + std::string(ex.what()));
+			}
+		}
+
+		bool Find(const K& key, T& out) const {
+			return FindKey(key, out);
+		}
+
+		template <typename Q, EnableIfTransparent<Q> = 0>
+		bool Find(const Q& key, T& out) const {
+			return FindKey(key, out);
+		}
+
+		bool Contains(const K& key) const {
+			return ContainsKey(key);
+		}
+
+		template <typename Q, EnableIfTransparent<Q> = 0>
+		bool Contains(const Q& key) const {
+			return ContainsKey(key);
+		}
+
+		void Pop(const K& key) {
+			PopKey(key);
+		}
+
+		template <typename Q, EnableIfTransparent<Q> = 0>
+		void Pop(const Q& key) {
+			PopKey(key);
+		}
+
+		void Erase() {
+			for (size_t i = 0; i < _count; i++) {
+				std::unique_lock<std::shared_mutex> lock(_shards[i].mutex);
+				_shards[i].table.Erase();
+			}
+		}
+
+		std::string ToString() const {
+			std::string text = ">>> Sharded Hash Table <<<\n";
+			text += "> shards: " + std::to_string(int(_count)) + "\n";
+			text += "> elements: " + std::to_string(int(Elements())) + "\n";
+
+			return text;
+		}
+	};
+
+	template <typename T, typename Hash = HF::Hash<std::string>, typename Chaining = HT::ListChaining>
+	using ShardedHashTable = ShardedHashMap<std::string, T, Hash, HF::Equal<std::string>, Chaining>;
+}
\ No newline at end of file
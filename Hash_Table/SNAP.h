@@ -0,0 +1,528 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <stdexcept>
+#include <ostream>
+#include <fstream>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include "HF.h"
+#include "HT.h"
+
+#if defined(_WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace SNAP {
+
+	// File layout, all sections 64-byte aligned and in native byte order:
+	// Header | bucket starts (capacity + 1) | entries (elements) | values (elements) | key blob | checksum
+	struct Header {
+		char magic[8];
+		uint32_t version;
+		uint32_t endian;
+		uint32_t key_size;
+		uint32_t value_size;
+		uint64_t probe_hash;
+		uint64_t elements;
+		uint64_t capacity;
+		uint64_t blob_size;
+		uint64_t value_align;
+	};
+
+	struct Entry {
+		uint64_t hash;
+		uint64_t key_offset;
+		uint64_t key_size;
+	};
+
+	static_assert(sizeof(Header) == 64, "SNAP::Header must stay 64 bytes");
+
+	constexpr char MAGIC[8] = { 'H', 'T', 'S', 'N', 'A', 'P', '\0', '\1' };
+	constexpr uint32_t VERSION = 1;
+	constexpr uint32_t ENDIAN = 0x01020304;
+	constexpr uint64_t ALIGN = 64;
+
+	inline uint64_t AlignUp(uint64_t offset) {
+		return (offset + ALIGN - 1) & ~(ALIGN - 1);
+	}
+
+	// FNV-1a over 8-byte words, then over the trailing bytes. Feeding it in chunks gives the
+	// same result as one call only when every chunk but the last is a multiple of 8 bytes.
+	inline uint64_t Checksum(const unsigned char* data, size_t size, uint64_t hash = 14695981039346656037ull) {
+		size_t i = 0;
+		for (; i + 8 <= size; i += 8) {
+			uint64_t word;
+			std::memcpy(&word, data + i, 8);
+			hash ^= word;
+			hash *= 1099511628211ull;
+		}
+		for (; i < size; i++) {
+			hash ^= data[i];
+			hash *= 1099511628211ull;
+		}
+		return hash;
+	}
+
+	template <typename K>
+	K ProbeKey() {
+		if constexpr (std::is_same_v<K, std::string> || std::is_same_v<K, std::string_view>) {
+			return K("HT::SNAP");
+		}
+		else if constexpr (std::is_arithmetic_v<K>) {
+			return K(0x5eed);
+		}
+		else {
+			return K{};
+		}
+	}
+
+	template <typename K>
+	struct KeyTraits {
+		static_assert(std::is_trivially_copyable_v<K>, "SNAP: K must be std::string or trivially copyable");
+
+		static constexpr uint32_t SIZE = sizeof(K);
+
+		static std::string_view Bytes(const K& key) {
+			return std::string_view(reinterpret_cast<const char*>(&key), sizeof(K));
+		}
+
+		static K FromBytes(const char* data, size_t) {
+			K key;
+			std::memcpy(&key, data, sizeof(K));
+			return key;
+		}
+	};
+
+	template <>
+	struct KeyTraits<std::string> {
+		static constexpr uint32_t SIZE = 0;
+
+		static std::string_view Bytes(const std::string& key) {
+			return key;
+		}
+
+		static std::string FromBytes(const char* data, size_t size) {
+			return std::string(data, size);
+		}
+	};
+
+	class Writer {
+		static constexpr size_t BUFFER = 1 << 20;
+
+		std::ostream& out;
+		std::vector<unsigned char> buffer;
+		uint64_t checksum;
+		uint64_t written;
+
+		void Flush() {
+			checksum = Checksum(buffer.data(), buffer.size(), checksum);
+			out.write(reinterpret_cast<const char*>(buffer.data()), std::streamsize(buffer.size()));
+			if (!out) {
+				throw std::runtime_error("SNAP::Write(): stream write failed");
+			}
+			buffer.clear();
+		}
+
+	public:
+		Writer(std::ostream& in_out) : out(in_out), checksum(14695981039346656037ull), written(0) {
+			buffer.reserve(BUFFER);
+		}
+
+		void Write(const void* data, size_t size) {
+			const unsigned char* bytes = static_cast<const unsigned char*>(data);
+			written += size;
+
+			while (size) {
+				size_t chunk = BUFFER - buffer.size() < size ? BUFFER - buffer.size() : size;
+				buffer.insert(buffer.end(), bytes, bytes + chunk);
+				bytes += chunk;
+				size -= chunk;
+
+				if (buffer.size() == BUFFER) {
+					Flush();
+				}
+			}
+		}
+
+		void Pad() {
+			static const unsigned char ZEROS[ALIGN] = {};
+			Write(ZEROS, size_t(AlignUp(written) - written));
+		}
+
+		void Finish() {
+			Flush();
+
+			uint64_t sum = checksum;
+			out.write(reinterpret_cast<const char*>(&sum), sizeof(sum));
+			out.flush();
+			if (!out) {
+				throw std::runtime_error("SNAP::Finish(): stream write failed");
+			}
+		}
+	};
+
+	template <typename K, typename T, typename Hash, typename KeyEqual, typename Chaining, typename Stats, typename Filter>
+	void Save(const HT::HashMap<K, T, Hash, KeyEqual, Chaining, Stats, Filter>& table, std::ostream& out) {
+		static_assert(std::is_trivially_copyable_v<T>, "SNAP::Save(): T must be trivially copyable");
+		static_assert(alignof(T) <= ALIGN, "SNAP::Save(): T is over-aligned");
+
+		using Node = typename HT::HashMap<K, T, Hash, KeyEqual, Chaining, Stats, Filter>::Node;
+
+		try {
+			uint64_t capacity = 1024;
+			while (capacity * 3 < table.Elements() * 4) {
+				capacity *= 2;
+			}
+
+			std::vector<uint64_t> starts(capacity + 1, 0);
+			uint64_t blob_size = 0;
+
+			table.ForEach([&starts, &blob_size, capacity](const Node& node) {
+				starts[(node.hash & (capacity - 1)) + 1]++;
+				blob_size += KeyTraits<K>::Bytes(node.key).size();
+			});
+			for (uint64_t i = 0; i < capacity; i++) {
+				starts[i + 1] += starts[i];
+			}
+
+			std::vector<const Node*> nodes(table.Elements());
+			std::vector<uint64_t> cursor(starts.begin(), starts.end() - 1);
+			table.ForEach([&nodes, &cursor, capacity](const Node& node) {
+				nodes[cursor[node.hash & (capacity - 1)]++] = &node;
+			});
+
+			Header header = {};
+			std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+			header.version = VERSION;
+			header.endian = ENDIAN;
+			header.key_size = KeyTraits<K>::SIZE;
+			header.value_size = sizeof(T);
+			header.probe_hash = Hash()(ProbeKey<K>());
+			header.elements = nodes.size();
+			header.capacity = capacity;
+			header.blob_size = blob_size;
+			header.value_align = alignof(T);
+
+			Writer writer(out);
+			writer.Write(&header, sizeof(header));
+			writer.Write(starts.data(), starts.size() * sizeof(uint64_t));
+			writer.Pad();
+
+			uint64_t key_offset = 0;
+			for (const Node* node : nodes) {
+				uint64_t key_size = KeyTraits<K>::Bytes(node->key).size();
+				Entry entry = { node->hash, key_offset, key_size };
+				writer.Write(&entry, sizeof(entry));
+				key_offset += key_size;
+			}
+			writer.Pad();
+
+			for (const Node* node : nodes) {
+				writer.Write(&node->value, sizeof(T));
+			}
+			writer.Pad();
+
+			for (const Node* node : nodes) {
+				std::string_view bytes = KeyTraits<K>::Bytes(node->key);
+				writer.Write(bytes.data(), bytes.size());
+			}
+			writer.Pad();
+
+			writer.Finish();
+		}
+		catch (const std::exception& ex) {
+			throw std::runtime_error("SNAP::Save() -> " + std::string(ex.what()));
+		}
+	}
+
+	template <typename K, typename T, typename Hash, typename KeyEqual, typename Chaining, typename Stats, typename Filter>
+	void Save(const HT::HashMap<K, T, Hash, KeyEqual, Chaining, Stats, Filter>& table, const std::string& path) {
+		std::ofstream out(path, std::ios::binary | std::ios::trunc);
+		if (!out) {
+			throw std::runtime_error("SNAP::Save(): could not open " + path);
+		}
+
+		Save(table, out);
+	}
+
+	class MappedFile {
+		const unsigned char* data;
+		size_t size;
+#if defined(_WIN32)
+		HANDLE file;
+		HANDLE mapping;
+#endif
+
+	public:
+		MappedFile(const std::string& path) : data(nullptr), size(0) {
+#if defined(_WIN32)
+			file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+			if (file == INVALID_HANDLE_VALUE) {
+				throw std::runtime_error("SNAP::MappedFile(): could not open " + path);
+			}
+
+			LARGE_INTEGER file_size;
+			if (!GetFileSizeEx(file, &file_size) || !file_size.QuadPart) {
+				CloseHandle(file);
+				throw std::runtime_error("SNAP::MappedFile(): could not size " + path);
+			}
+			size = size_t(file_size.QuadPart);
+
+			mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+			if (!mapping) {
+				CloseHandle(file);
+				throw std::runtime_error("SNAP::MappedFile(): could not map " + path);
+			}
+
+			data = static_cast<const unsigned char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+			if (!data) {
+				CloseHandle(mapping);
+				CloseHandle(file);
+				throw std::runtime_error("SNAP::MappedFile(): could not map " + path);
+			}
+#else
+			int fd = open(path.c_str(), O_RDONLY);
+			if (fd < 0) {
+				throw std::runtime_error("SNAP::MappedFile(): could not open " + path);
+			}
+
+			struct stat info;
+			if (fstat(fd, &info) != 0 || info.st_size <= 0) {
+				close(fd);
+				throw std::runtime_error("SNAP::MappedFile(): could not size " + path);
+			}
+			size = size_t(info.st_size);
+
+			void* mapped = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+			close(fd);
+			if (mapped == MAP_FAILED) {
+				throw std::runtime_error("SNAP::MappedFile(): could not map " + path);
+			}
+			data = static_cast<const unsigned char*>(mapped);
+#endif
+		}
+
+		~MappedFile() {
+#if defined(_WIN32)
+			UnmapViewOfFile(data);
+			CloseHandle(mapping);
+			CloseHandle(file);
+#else
+			munmap(const_cast<unsigned char*>(data), size);
+#endif
+		}
+
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+
+		const unsigned char* Data() const {
+			return data;
+		}
+
+		size_t Size() const {
+			return size;
+		}
+	};
+
+	template <typename K, typename T, typename Hash = HF::Hash<K>, typename KeyEqual = HF::Equal<K>>
+	class Snapshot {
+		static_assert(std::is_trivially_copyable_v<T>, "SNAP::Snapshot: T must be trivially copyable");
+
+		template <typename Q>
+		using EnableIfTransparent = std::enable_if_t<!std::is_void_v<Q> && HF::IsTransparent<Hash, KeyEqual>::value, int>;
+
+		Hash _hash;
+		KeyEqual _equal;
+		MappedFile _file;
+		const Header* _header;
+		const uint64_t* _starts;
+		const Entry* _entries;
+		const T* _values;
+		const char* _blob;
+
+		template <typename Q>
+		bool Matches(const Entry& entry, const Q& key) const {
+			if constexpr (std::is_same_v<K, std::string>) {
+				return _equal(std::string_view(_blob + entry.key_offset, size_t(entry.key_size)), key);
+			}
+			else {
+				return _equal(KeyTraits<K>::FromBytes(_blob + entry.key_offset, size_t(entry.key_size)), key);
+			}
+		}
+
+		// Opening only checks the header, so buckets and entries are bounds-checked as lookups reach them.
+		bool InBounds(const Entry& entry) const {
+			if (entry.key_offset > _header->blob_size || entry.key_size > _header->blob_size - entry.key_offset) {
+				return false;
+			}
+			return !KeyTraits<K>::SIZE || entry.key_size == KeyTraits<K>::SIZE;
+		}
+
+		template <typename Q>
+		const T* FindKey(const Q& key) const {
+			uint64_t hash = _hash(key);
+			uint64_t bucket = hash & (_header->capacity - 1);
+			uint64_t first = _starts[bucket];
+			uint64_t last = _starts[bucket + 1];
+
+			if (first > last || last > _header->elements) {
+				throw std::runtime_error("SNAP::Find(): corrupt bucket table");
+			}
+
+			for (uint64_t i = first; i < last; i++) {
+				if (_entries[i].hash == hash) {
+					if (!InBounds(_entries[i])) {
+						throw std::runtime_error("SNAP::Find(): corrupt key entry");
+					}
+					if (Matches(_entries[i], key)) {
+						return &_values[i];
+					}
+				}
+			}
+
+			return nullptr;
+		}
+
+		void Validate() {
+			size_t size = _file.Size();
+			if (size < sizeof(Header) + sizeof(uint64_t)) {
+				throw std::runtime_error("file too small");
+			}
+
+			_header = reinterpret_cast<const Header*>(_file.Data());
+			if (std::memcmp(_header->magic, MAGIC, sizeof(MAGIC)) != 0) {
+				throw std::runtime_error("not a snapshot");
+			}
+			if (_header->version != VERSION || _header->endian != ENDIAN) {
+				throw std::runtime_error("unsupported version or byte order");
+			}
+			if (_header->key_size != KeyTraits<K>::SIZE || _header->value_size != sizeof(T) || _header->value_align != alignof(T)) {
+				throw std::runtime_error("key or value type does not match");
+			}
+			if (_header->probe_hash != _hash(ProbeKey<K>())) {
+				throw std::runtime_error("hash function does not match");
+			}
+			if (!_header->capacity || (_header->capacity & (_header->capacity - 1)) || _header->capacity > size / sizeof(uint64_t) || _header->elements > size / sizeof(Entry) || _header->blob_size > size) {
+				throw std::runtime_error("corrupt header");
+			}
+
+			uint64_t starts_offset = sizeof(Header);
+			uint64_t entries_offset = AlignUp(starts_offset + (_header->capacity + 1) * sizeof(uint64_t));
+			uint64_t values_offset = AlignUp(entries_offset + _header->elements * sizeof(Entry));
+			uint64_t blob_offset = AlignUp(values_offset + _header->elements * sizeof(T));
+			uint64_t end_offset = AlignUp(blob_offset + _header->blob_size);
+
+			if (end_offset + sizeof(uint64_t) != size) {
+				throw std::runtime_error("file size does not match header");
+			}
+
+			_starts = reinterpret_cast<const uint64_t*>(_file.Data() + starts_offset);
+			_entries = reinterpret_cast<const Entry*>(_file.Data() + entries_offset);
+			_values = reinterpret_cast<const T*>(_file.Data() + values_offset);
+			_blob = reinterpret_cast<const char*>(_file.Data() + blob_offset);
+
+			if (_starts[_header->capacity] != _header->elements) {
+				throw std::runtime_error("corrupt bucket table");
+			}
+		}
+
+	public:
+		using Key = K;
+
+		Snapshot(const std::string& path, bool verify = false) try : _file(path) {
+			Validate();
+
+			if (verify && !Verify()) {
+				throw std::runtime_error("checksum mismatch");
+			}
+		}
+		catch (const std::exception& ex) {
+			throw std::runtime_error("SNAP::Snapshot() -> " + std::string(ex.what()));
+		}
+
+		Snapshot(const Snapshot&) = delete;
+		Snapshot& operator=(const Snapshot&) = delete;
+
+		bool Verify() const {
+			size_t size = _file.Size() - sizeof(uint64_t);
+			uint64_t stored;
+			std::memcpy(&stored, _file.Data() + size, sizeof(stored));
+
+			return Checksum(_file.Data(), size) == stored;
+		}
+
+		size_t Elements() const {
+			return size_t(_header->elements);
+		}
+
+		size_t Capacity() const {
+			return size_t(_header->capacity);
+		}
+
+		const T* Find(const K& key) const {
+			return FindKey(key);
+		}
+
+		template <typename Q, EnableIfTransparent<Q> = 0>
+		const T* Find(const Q& key) const {
+			return FindKey(key);
+		}
+
+		bool Contains(const K& key) const {
+			return FindKey(key) != nullptr;
+		}
+
+		template <typename Q, EnableIfTransparent<Q> = 0>
+		bool Contains(const Q& key) const {
+			return FindKey(key) != nullptr;
+		}
+
+		template <typename Function>
+		void ForEach(Function fn) const {
+			for (uint64_t i = 0; i < _header->elements; i++) {
+				const Entry& entry = _entries[i];
+				if (!InBounds(entry)) {
+					throw std::runtime_error("SNAP::ForEach(): corrupt key entry");
+				}
+				fn(KeyTraits<K>::FromBytes(_blob + entry.key_offset, size_t(entry.key_size)), _values[i]);
+			}
+		}
+
+		template <typename Chaining, typename Stats, typename Filter>
+		void Load(HT::HashMap<K, T, Hash, KeyEqual, Chaining, Stats, Filter>& table) const {
+			try {
+				table.Reserve(table.Elements() + Elements());
+				ForEach([&table](const K& key, const T& value) { table.Push(key, value); });
+			}
+			catch (const std::exception& ex) {
+				throw std::runtime_error("SNAP::Load() -> " + std::string(ex.what()));
+			}
+		}
+
+		std::string ToString() const {
+			std::string text = ">>> Snapshot <<<\n";
+			text += "> elements: " + std::to_string(Elements()) + "\n";
+			text += "> buckets: " + std::to_string(Capacity()) + "\n";
+			text += "> bytes: " + std::to_string(_file.Size()) + "\n";
+
+			return text;
+		}
+	};
+
+	template <typename T, typename Hash = HF::Hash<std::string>>
+	using TableSnapshot = Snapshot<std::string, T, Hash, HF::Equal<std::string>>;
+}
@@ -0,0 +1,391 @@
+#pragma once
+#include <string>
+#include <stdexcept>
+#include <cstddef>
+#include <cstdint>
+#include <chrono>
+#include <utility>
+#include "HT.h"
+#include "DLL.h"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace TTL {
+
+	// Milliseconds of std::chrono::steady_clock; a clock is any functor returning monotonic uint64_t ticks.
+	struct SteadyClock {
+		uint64_t operator()() const {
+			return uint64_t(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+		}
+	};
+
+	// HT::HashMap whose entries may carry a time to live. Deadlines sit in a hierarchical timer wheel
+	// of LEVELS x SLOTS lists: an entry lives on the level of the highest 6-bit group in which its
+	// deadline differs from the current time and is cascaded one level down when time reaches its
+	// slot. Advancing jumps straight to the next occupied slot, so reclaiming costs O(1) amortized
+	// per expired entry and never walks the table. Deadlines past the wheel range wait on an
+	// overflow list that is rescheduled once per rotation of the top level. Not thread safe.
+	template <typename K, typename T, typename Clock = SteadyClock, typename Hash = HF::Hash<K>, typename KeyEqual = HF::Equal<K>>
+	class ExpiringMap {
+
+		static constexpr size_t BITS = 6;
+		static constexpr size_t SLOTS = size_t(1) << BITS;
+		static constexpr size_t LEVELS = 4;
+		static constexpr uint64_t RANGE = uint64_t(1) << (BITS * LEVELS);
+		static constexpr size_t OVERFLOW_LIST = LEVELS * SLOTS;
+		static constexpr size_t NO_LIST = OVERFLOW_LIST + 1;
+		static constexpr uint64_t NEVER = UINT64_MAX;
+
+		// Spreads resizes over later operations, as LRU::Cache does.
+		static constexpr size_t REHASH_STEP = 64;
+
+		struct Entry;
+
+		using List = DLL::DoubLinList<Entry*>;
+
+		struct Entry {
+			T value;
+			const K* key;
+			uint64_t deadline;
+			typename List::Cursor cursor;
+			size_t list;
+
+			template <typename... Args>
+			Entry(std::in_place_t, Args&&... args) : value(std::forward<Args>(args)...), key(nullptr), deadline(NEVER), cursor(), list(NO_LIST) {}
+		};
+
+		using Index = HT::HashMap<K, Entry, Hash, KeyEqual, HT::IntrusiveChaining>;
+
+		Index _index;
+		typename List::NodePool _list_pool;
+		List _wheel[LEVELS * SLOTS + 1];
+		uint64_t _occupied[LEVELS];
+		Clock _clock;
+		uint64_t _now;
+		size_t _expiring;
+		size_t _expired;
+
+		static size_t Ctz(uint64_t bits) {
+#if defined(_MSC_VER)
+			unsigned long index;
+			_BitScanForward64(&index, bits);
+			return size_t(index);
+#else
+			return size_t(__builtin_ctzll(bits));
+#endif
+		}
+
+		// Expects deadline > _now.
+		void Schedule(Entry* entry) {
+			uint64_t diff = entry->deadline ^ _now;
+			size_t level = 0;
+			while (level < LEVELS && diff >> (BITS * (level + 1))) {
+				level++;
+			}
+
+			if (level == LEVELS) {
+				entry->list = OVERFLOW_LIST;
+			}
+			else {
+				size_t slot = size_t(entry->deadline >> (BITS * level)) & (SLOTS - 1);
+				entry->list = level * SLOTS + slot;
+				_occupied[level] |= uint64_t(1) << slot;
+			}
+
+			entry->cursor = _wheel[entry->list].PushBack(entry);
+		}
+
+		void MarkIfEmpty(size_t list) {
+			if (list != OVERFLOW_LIST && !_wheel[list].Size()) {
+				_occupied[list / SLOTS] &= ~(uint64_t(1) << (list % SLOTS));
+			}
+		}
+
+		void Unschedule(Entry* entry) {
+			if (entry->list == NO_LIST) {
+				return;
+			}
+
+			_wheel[entry->list].EraseAt(entry->cursor);
+			MarkIfEmpty(entry->list);
+			entry->list = NO_LIST;
+			_expiring--;
+		}
+
+		void Reclaim(Entry* entry) {
+			Unschedule(entry);
+			_index.Pop(*entry->key);
+			_expired++;
+		}
+
+		// Takes every entry off the list and expires or reschedules it against the current time.
+		void Cascade(size_t list) {
+			for (size_t count = _wheel[list].Size(); count; count--) {
+				Entry* entry = List::At(_wheel[list].First());
+				_wheel[list].PopFront();
+
+				if (entry->deadline <= _now) {
+					entry->list = NO_LIST;
+					_expiring--;
+					_index.Pop(*entry->key);
+					_expired++;
+				}
+				else {
+					Schedule(entry);
+				}
+			}
+			MarkIfEmpty(list);
+		}
+
+		// Time of the next occupied slot after _now: a deadline on level 0, a cascade above it.
+		uint64_t NextEvent() const {
+			uint64_t next = NEVER;
+
+			for (size_t level = 0; level < LEVELS; level++) {
+				size_t current = size_t(_now >> (BITS * level)) & (SLOTS - 1);
+				uint64_t later = _occupied[level] & ~((uint64_t(2) << current) - 1);
+				if (later) {
+					uint64_t base = _now >> (BITS * (level + 1)) << (BITS * (level + 1));
+					uint64_t time = base + (uint64_t(Ctz(later)) << (BITS * level));
+					next = time < next ? time : next;
+				}
+			}
+
+			if (_wheel[OVERFLOW_LIST].Size()) {
+				uint64_t time = (_now / RANGE + 1) * RANGE;
+				next = time < next ? time : next;
+			}
+
+			return next;
+		}
+
+		void Advance(uint64_t now) {
+			for (uint64_t next = NextEvent(); next <= now; next = NextEvent()) {
+				_now = next;
+
+				if (_now % RANGE == 0) {
+					Cascade(OVERFLOW_LIST);
+				}
+				for (size_t level = LEVELS - 1; level > 0; level--) {
+					if (_now % (uint64_t(1) << (BITS * level)) == 0) {
+						Cascade(level * SLOTS + (size_t(_now >> (BITS * level)) & (SLOTS - 1)));
+					}
+				}
+				Cascade(size_t(_now) & (SLOTS - 1));
+			}
+
+			if (now > _now) {
+				_now = now;
+			}
+		}
+
+		template <typename KArg, typename M>
+		T* Store(KArg&& key, M&& value, uint64_t ttl) {
+			Advance(_clock());
+
+			auto result = _index.TryEmplace(std::forward<KArg>(key), std::in_place, std::forward<M>(value));
+			Entry& entry = result.first->value;
+
+			if (result.second) {
+				entry.key = &result.first->key;
+			}
+			else {
+				entry.value = std::forward<M>(value);
+				Unschedule(&entry);
+			}
+
+			entry.deadline = ttl == NEVER ? NEVER : _now + ttl;
+			if (entry.deadline != NEVER) {
+				try {
+					Schedule(&entry);
+				}
+				catch (...) {
+					_index.Pop(*entry.key);
+					throw;
+				}
+				_expiring++;
+			}
+
+			return &entry.value;
+		}
+
+	public:
+		using Key = K;
+
+		ExpiringMap(size_t expected = 0, Clock clock = Clock()) : _index(expected), _occupied(), _clock(clock), _expiring(0), _expired(0) {
+			for (List& list : _wheel) {
+				list.SetPool(&_list_pool);
+			}
+
+			_index.SetReHashStep(REHASH_STEP);
+			_now = _clock();
+		}
+
+		ExpiringMap(const ExpiringMap&) = delete;
+		ExpiringMap& operator=(const ExpiringMap&) = delete;
+
+		~ExpiringMap() {
+			for (List& list : _wheel) {
+				list.Erase();
+			}
+		}
+
+		size_t Elements() const {
+			return _index.Elements();
+		}
+
+		// Entries that carry a deadline.
+		size_t Expiring() const {
+			return _expiring;
+		}
+
+		// Entries reclaimed by expiry since construction.
+		size_t Expired() const {
+			return _expired;
+		}
+
+		uint64_t Now() const {
+			return _now;
+		}
+
+		// Reclaims every entry whose deadline is at or before now; earlier times are ignored.
+		void Tick(uint64_t now) {
+			try {
+				Advance(now);
+			}
+			catch (const std::exception& ex) {
+				throw std::runtime_error("TTL::Tick() -> " + std::string(ex.what()));
+			}
+		}
+
+		void Tick() {
+			Tick(_clock());
+		}
+
+		// Inserts or replaces an entry that never expires; a previous deadline is dropped.
+		template <typename M>
+		T* Push(const K& key, M&& value) {
+			try {
+				return Store(key, std::forward<M>(value), NEVER);
+			}
+			catch (const std::exception& ex) {
+				throw std::runtime_error("TTL::Push() -> " + std::string(ex.what()));
+			}
+		}
+
+		template <typename M>
+		T* Push(K&& key, M&& value) {
+			try {
+				return Store(std::move(key), std::forward<M>(value), NEVER);
+			}
+			catch (const std::exception& ex) {
+				throw std::runtime_error("TTL::Push() -> " + std::string(ex.what()));
+			}
+		}
+
+		// Inserts or replaces an entry that expires ttl clock ticks from now. A ttl of zero stores nothing
+		// and removes the key, since the entry would already be expired.
+		template <typename M>
+		T* Push(const K& key, M&& value, uint64_t ttl) {
+			try {
+				if (!ttl) {
+					Pop(key);
+					return nullptr;
+				}
+				return Store(key, std::forward<M>(value), ttl < RANGE * RANGE ? ttl : RANGE * RANGE);
+			}
+			catch (const std::exception& ex) {
+				throw std::runtime_error("TTL::Push() -> " + std::string(ex.what()));
+			}
+		}
+
+		template <typename M>
+		T* Push(K&& key, M&& value, uint64_t ttl) {
+			try {
+				if (!ttl) {
+					Pop(key);
+					return nullptr;
+				}
+				return Store(std::move(key), std::forward<M>(value), ttl < RANGE * RANGE ? ttl : RANGE * RANGE);
+			}
+			catch (const std::exception& ex) {
+				throw std::runtime_error("TTL::Push() -> " + std::string(ex.what()));
+			}
+		}
+
+		// Advances the wheel to the clock first, so an expired entry is never returned.
+		T* Find(const K& key) {
+			Tick();
+
+			typename Index::Node* node = _index.Find(key);
+			return node ? &node->value.value : nullptr;
+		}
+
+		// Looks the key up without reclaiming anything; entries past their deadline read as missing.
+		const T* Peek(const K& key) const {
+			typename Index::Node* node = _index.Find(key);
+			return node && (node->value.deadline == NEVER || node->value.deadline > _clock()) ? &node->value.value : nullptr;
+		}
+
+		bool Contains(const K& key) const {
+			return Peek(key) != nullptr;
+		}
+
+		// Clock ticks left before the key expires, NEVER for a key without a deadline and 0 for a missing one.
+		uint64_t TimeToLive(const K& key) const {
+			typename Index::Node* node = _index.Find(key);
+			if (!node) {
+				return 0;
+			}
+
+			uint64_t now = _clock();
+			return node->value.deadline == NEVER ? NEVER : node->value.deadline > now ? node->value.deadline - now : 0;
+		}
+
+		bool Pop(const K& key) {
+			try {
+				Tick();
+
+				typename Index::Node* node = _index.Find(key);
+				if (!node) {
+					return false;
+				}
+
+				Unschedule(&node->value);
+				_index.Pop(key);
+			}
+			catch (const std::exception& ex) {
+				throw std::runtime_error("TTL::Pop() -> " + std::string(ex.what()));
+			}
+
+			return true;
+		}
+
+		void Erase() {
+			for (List& list : _wheel) {
+				list.Erase();
+			}
+			for (uint64_t& occupied : _occupied) {
+				occupied = 0;
+			}
+
+			_index.Erase();
+			_expiring = 0;
+		}
+
+		std::string ToString() const {
+			std::string text = ">>> Expiring Hash Table <<<\n";
+			text += "> elements: " + std::to_string(Elements()) + "\n";
+			text += "> expiring: " + std::to_string(_expiring) + "\n";
+			text += "> expired: " + std::to_string(_expired) + "\n";
+			text += "> overflow: " + std::to_string(_wheel[OVERFLOW_LIST].Size()) + "\n";
+
+			return text;
+		}
+	};
+
+	template <typename T, typename Clock = SteadyClock, typename Hash = HF::Hash<std::string>>
+	using ExpiringTable = ExpiringMap<std::string, T, Clock, Hash, HF::Equal<std::string>>;
+}